@@ -0,0 +1,218 @@
+// AdmissionController.cpp
+#include "AdmissionController.h"
+#include <algorithm>
+
+namespace {
+
+// 当前工作线程正在处理的请求占用的类别，-1 表示没有
+thread_local int tlsHeld = -1;
+
+// 当前连接任务进入执行器队列的时间，被第一个请求取走后清空
+thread_local std::chrono::steady_clock::time_point tlsQueuedAt;
+
+const int kClassCount = static_cast<int>(AdmissionClass::Count);
+
+} // namespace
+
+AdmissionController& AdmissionController::getInstance() {
+    static AdmissionController instance;
+    return instance;
+}
+
+AdmissionController::AdmissionController() : enabled_(true) {
+    Metrics &metrics = Metrics::getInstance();
+    for (int i = 0; i < kClassCount; i++) {
+        ClassState &state = classes_[i];
+        MetricLabels labels = {{"class", className(static_cast<AdmissionClass>(i))}};
+        state.limits = defaultLimits(static_cast<AdmissionClass>(i), CPPHTTPLIB_THREAD_POOL_COUNT);
+        state.inFlightGauge = &metrics.gauge(
+            "todo_http_admission_in_flight", "Requests holding an admission permit", labels);
+        state.admitted = &metrics.counter(
+            "todo_http_admission_admitted_total", "Requests admitted", labels);
+        MetricLabels full = labels;
+        full.push_back({"reason", "queue_full"});
+        state.shedQueueFull = &metrics.counter(
+            "todo_http_admission_shed_total", "Requests rejected with 503 by admission control", full);
+        MetricLabels timeout = labels;
+        timeout.push_back({"reason", "timeout"});
+        state.shedTimeout = &metrics.counter(
+            "todo_http_admission_shed_total", "Requests rejected with 503 by admission control", timeout);
+        state.waitTime = &metrics.histogram(
+            "todo_http_admission_wait_seconds", "Time spent waiting for an admission permit", labels);
+    }
+}
+
+// 排队的请求也占着工作线程（在条件变量上等），所以修改和登录两类的
+// 同时处理数 + 排队数加起来必须小于工作线程数，剩下的 reservedWorkers() 个线程只有读请求能用到
+size_t AdmissionController::reservedWorkers(size_t workers) {
+    return std::max<size_t>(workers / 4, 1);
+}
+
+AdmissionLimits AdmissionController::defaultLimits(AdmissionClass cls, size_t workers) {
+    workers = std::max<size_t>(workers, 1);
+    // 修改和登录合计可占用的线程数，登录最多 2 个（1 个在算 Argon2、1 个排队），其余给修改
+    size_t blocking = workers > reservedWorkers(workers) ? workers - reservedWorkers(workers) : 1;
+    size_t auth = std::min<size_t>(std::max<size_t>(blocking / 2, 1), 2);
+    size_t mutation = blocking > auth ? blocking - auth : 1;
+
+    AdmissionLimits limits;
+    switch (cls) {
+    case AdmissionClass::Static:
+    case AdmissionClass::Read:
+        limits.maxInFlight = workers;
+        limits.maxWaiting = std::max<size_t>(workers / 2, 1);
+        limits.maxWait = std::chrono::milliseconds(500);
+        limits.retryAfterSec = 1;
+        break;
+    case AdmissionClass::Mutation:
+        limits.maxInFlight = std::max<size_t>(mutation * 3 / 4, 1);
+        limits.maxWaiting = mutation - std::min(mutation, limits.maxInFlight);
+        limits.maxWait = std::chrono::milliseconds(1000);
+        limits.retryAfterSec = 1;
+        break;
+    default:
+        // Argon2 在 PasswordHasher 里是串行的，多放进来只会占着线程等锁
+        limits.maxInFlight = 1;
+        limits.maxWaiting = auth - 1;
+        limits.maxWait = std::chrono::milliseconds(1000);
+        limits.retryAfterSec = 2;
+        break;
+    }
+    return limits;
+}
+
+void AdmissionController::configure(AdmissionClass cls, const AdmissionLimits &limits) {
+    ClassState &state = classes_[static_cast<int>(cls)];
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.limits = limits;
+    if (state.limits.maxInFlight == 0) {
+        state.limits.maxInFlight = 1;
+    }
+}
+
+AdmissionLimits AdmissionController::limits(AdmissionClass cls) {
+    ClassState &state = classes_[static_cast<int>(cls)];
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.limits;
+}
+
+AdmissionClass AdmissionController::classify(const httplib::Request &req) {
+    const std::string &path = req.path;
+    if (path.compare(0, 5, "/api/") != 0 && path != "/metrics") {
+        return AdmissionClass::Static;
+    }
+    if (path == "/api/login" || path == "/api/register") {
+        return AdmissionClass::Auth;
+    }
+    if (req.method == "GET" || req.method == "HEAD") {
+        return AdmissionClass::Read;
+    }
+    return AdmissionClass::Mutation;
+}
+
+const char *AdmissionController::className(AdmissionClass cls) {
+    switch (cls) {
+    case AdmissionClass::Static:   return "static";
+    case AdmissionClass::Read:     return "read";
+    case AdmissionClass::Mutation: return "mutation";
+    case AdmissionClass::Auth:     return "auth";
+    default:                       return "unknown";
+    }
+}
+
+bool AdmissionController::tryAcquire(ClassState &state) {
+    size_t current = state.inFlight.load(std::memory_order_relaxed);
+    while (current < state.limits.maxInFlight) {
+        if (state.inFlight.compare_exchange_weak(current, current + 1, std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+AdmissionController::Outcome AdmissionController::acquire(ClassState &state,
+                                                          std::chrono::steady_clock::time_point queuedAt) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = queuedAt + state.limits.maxWait;
+    // 在执行器队列里已经等过了期限，客户端多半已经放弃，不再处理
+    if (start >= deadline) {
+        return Outcome::Timeout;
+    }
+    if (tryAcquire(state)) {
+        return Outcome::Admitted;
+    }
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+    if (state.waiting.load(std::memory_order_relaxed) >= state.limits.maxWaiting) {
+        return Outcome::QueueFull;
+    }
+    // 先登记排队再检查名额，与 release() 的先归还再检查排队配对，不会漏掉唤醒
+    state.waiting.fetch_add(1, std::memory_order_seq_cst);
+    bool admitted = state.released.wait_until(lock, deadline,
+                                              [&] { return tryAcquire(state); });
+    state.waiting.fetch_sub(1, std::memory_order_relaxed);
+    lock.unlock();
+
+    state.waitTime->observe(std::chrono::steady_clock::now() - start);
+    return admitted ? Outcome::Admitted : Outcome::Timeout;
+}
+
+void AdmissionController::release(ClassState &state) {
+    state.inFlight.fetch_sub(1, std::memory_order_seq_cst);
+    state.inFlightGauge->sub();
+    if (state.waiting.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.released.notify_one();
+    }
+}
+
+void AdmissionController::noteQueued(std::chrono::steady_clock::time_point enqueued) {
+    tlsQueuedAt = enqueued;
+}
+
+bool AdmissionController::enter(const httplib::Request &req, httplib::Response &res) {
+    // 上一个请求没有走到 post-routing（例如连接中途出错）时先把名额还回去
+    leave();
+    std::chrono::steady_clock::time_point queuedAt = tlsQueuedAt;
+    tlsQueuedAt = std::chrono::steady_clock::time_point();
+    if (queuedAt == std::chrono::steady_clock::time_point()) {
+        queuedAt = std::chrono::steady_clock::now();
+    }
+    if (!enabled_) {
+        return true;
+    }
+
+    int index = static_cast<int>(classify(req));
+    ClassState &state = classes_[index];
+    Outcome outcome = acquire(state, queuedAt);
+    if (outcome == Outcome::Admitted) {
+        state.inFlightGauge->add();
+        state.admitted->inc();
+        tlsHeld = index;
+        return true;
+    }
+
+    (outcome == Outcome::QueueFull ? state.shedQueueFull : state.shedTimeout)->inc();
+    res.status = 503;
+    res.set_header("Retry-After", std::to_string(state.limits.retryAfterSec));
+    res.set_content(R"({"status": "error", "message": "Server busy, please retry later"})", "application/json");
+    return false;
+}
+
+void AdmissionController::leave() {
+    if (tlsHeld < 0) {
+        return;
+    }
+    ClassState &state = classes_[tlsHeld];
+    tlsHeld = -1;
+    release(state);
+}
+
+std::shared_ptr<void> AdmissionController::detach() {
+    if (tlsHeld < 0) {
+        return nullptr;
+    }
+    ClassState *state = &classes_[tlsHeld];
+    tlsHeld = -1;
+    return std::shared_ptr<void>(state, [this](void *p) { release(*static_cast<ClassState *>(p)); });
+}
@@ -0,0 +1,101 @@
+// AdmissionController.h
+#ifndef ADMISSION_CONTROLLER_H
+#define ADMISSION_CONTROLLER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "httplib.h"
+#include "Metrics.h"
+
+// 请求类别，按开销和重要性区分
+enum class AdmissionClass : int {
+    Static = 0,   // ./www 下的静态文件
+    Read,         // 只读 API（GET/HEAD），包括 /api/health 和 /metrics
+    Mutation,     // 修改数据的 API（POST/PUT/PATCH/DELETE）
+    Auth,         // 登录和注册，每次都要做一次 Argon2
+    Count
+};
+
+// 单个类别的限制
+struct AdmissionLimits {
+    size_t maxInFlight = 8;                      // 同时处理的请求数上限
+    size_t maxWaiting = 4;                       // 排队等待名额的请求数上限，超出直接拒绝
+    std::chrono::milliseconds maxWait{500};      // 排队的最长时间，超时拒绝
+    int retryAfterSec = 1;                       // 拒绝时 Retry-After 的秒数
+};
+
+// 准入控制。每个请求在进入处理前按类别领取名额：
+// - 名额充足时只做一次 CAS，不加锁；
+// - 名额用完时在该类别的条件变量上排队，排队人数或时间超限就立即返回 503 和 Retry-After，
+//   不让请求在线程池里无限堆积。排队时间从连接进入执行器队列算起（见 noteQueued），
+//   在执行器里已经等过 maxWait 的请求直接拒绝；
+// - 各类别名额独立。排队的请求同样占着工作线程，默认配置下修改和登录两类的
+//   同时处理数 + 排队数合计比工作线程数少 reservedWorkers() 个（8 个线程时留 2 个），
+//   慢的 Argon2 登录和写操作再多也占不满工作线程（工作线程少于 3 个时无法预留）。
+// 名额在 pre-routing 阶段领取、post-routing 阶段归还（同一个工作线程，用线程局部变量记录）。
+// 流式响应的数据库读取发生在写 body 的过程中，处理函数用 detach() 把名额交给内容提供函数，写完才归还。
+class AdmissionController {
+public:
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    static AdmissionController& getInstance();
+
+    // 按工作线程数生成默认限制
+    static AdmissionLimits defaultLimits(AdmissionClass cls, size_t workers);
+    // 修改和登录两类合计不能占用、留给读请求的工作线程数
+    static size_t reservedWorkers(size_t workers);
+
+    // 启动前调用；enabled 为 false 时所有请求直接放行
+    void configure(AdmissionClass cls, const AdmissionLimits &limits);
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    AdmissionLimits limits(AdmissionClass cls);
+
+    static AdmissionClass classify(const httplib::Request &req);
+    static const char *className(AdmissionClass cls);
+
+    // 执行器在工作线程上运行一个连接任务前调用，记下任务进入执行器队列的时间。
+    // 该任务处理的第一个请求从这个时间开始计算排队期限（执行器队列 + 等名额合计不超过 maxWait），
+    // 之后同一连接上的 keep-alive 请求没有在执行器里排队，从进入 pre-routing 开始计算
+    static void noteQueued(std::chrono::steady_clock::time_point enqueued);
+
+    // 为请求领取名额。被拒绝时填好 503 响应并返回 false
+    bool enter(const httplib::Request &req, httplib::Response &res);
+    // 归还本线程当前请求的名额（没有时什么都不做）
+    void leave();
+    // 把本线程当前请求的名额转交给返回的对象，最后一个副本销毁时才归还，之后的 leave() 不再归还它。
+    // 没有名额（准入控制关闭）时返回空指针
+    std::shared_ptr<void> detach();
+
+private:
+    AdmissionController();
+
+    enum class Outcome { Admitted, QueueFull, Timeout };
+
+    struct alignas(64) ClassState {
+        AdmissionLimits limits;
+        std::atomic<size_t> inFlight{0};
+        std::atomic<size_t> waiting{0};
+        std::mutex mutex;                       // 只在排队和唤醒时使用
+        std::condition_variable released;
+
+        Gauge *inFlightGauge = nullptr;
+        Counter *admitted = nullptr;
+        Counter *shedQueueFull = nullptr;
+        Counter *shedTimeout = nullptr;
+        Histogram *waitTime = nullptr;
+    };
+
+    bool tryAcquire(ClassState &state);
+    Outcome acquire(ClassState &state, std::chrono::steady_clock::time_point queuedAt);
+    void release(ClassState &state);
+
+    bool enabled_;
+    ClassState classes_[static_cast<int>(AdmissionClass::Count)];
+};
+
+#endif // ADMISSION_CONTROLLER_H
@@ -0,0 +1,63 @@
+// AsyncDatabase.cpp
+#include "AsyncDatabase.h"
+#include "ConnectionPool.h"
+
+DbExecutor::DbExecutor(size_t threads) : shutdown_(false) {
+    if (threads == 0) {
+        threads = 1;
+    }
+    for (size_t i = 0; i < threads; i++) {
+        threads_.emplace_back(&DbExecutor::worker, this);
+    }
+}
+
+DbExecutor::~DbExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+    }
+    cond_.notify_all();
+    for (auto &t : threads_) {
+        t.join();
+    }
+}
+
+void DbExecutor::worker() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [&] { return !jobs_.empty() || shutdown_; });
+            // 关闭时先把已提交的任务做完，保证 future 都有结果
+            if (jobs_.empty()) {
+                break;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+
+AsyncDatabase& AsyncDatabase::getInstance() {
+    static AsyncDatabase instance;
+    return instance;
+}
+
+// 线程数与连接池上限一致，更多线程只会在借连接时排队
+AsyncDatabase::AsyncDatabase() : data_(Storage::getInstance()) {
+    data_.connect();
+    executor_.reset(new DbExecutor(ConnectionPool::getInstance().config().maxSize));
+}
+
+std::future<std::vector<Task>> AsyncDatabase::getUserTasks(int id) {
+    return executor_->submit([this, id]() {
+        return data_.getUserTasks(id);
+    });
+}
+
+std::future<User> AsyncDatabase::getUser(int id) {
+    return executor_->submit([this, id]() {
+        return data_.getUser(id);
+    });
+}
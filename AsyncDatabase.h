@@ -0,0 +1,70 @@
+// AsyncDatabase.h
+#ifndef ASYNC_DATABASE_H
+#define ASYNC_DATABASE_H
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+#include "Storage.h"
+
+// 专门执行数据库调用的线程池，httplib 的工作线程只负责提交和等待结果
+class DbExecutor {
+public:
+    explicit DbExecutor(size_t threads);
+    ~DbExecutor();
+
+    DbExecutor(const DbExecutor&) = delete;
+    DbExecutor& operator=(const DbExecutor&) = delete;
+
+    template<class F>
+    auto submit(F f) -> std::future<decltype(f())> {
+        typedef decltype(f()) R;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::move(f));
+        std::future<R> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back([task]() { (*task)(); });
+        }
+        cond_.notify_one();
+        return result;
+    }
+
+private:
+    void worker();
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<std::function<void()>> jobs_;
+    std::vector<std::thread> threads_;
+    bool shutdown_;
+};
+
+// 存储接口的异步版本：每个调用在 DbExecutor 上执行并立即返回 future。
+// 互不依赖的查询可以同时发出再一起等待，总耗时是最慢的那个而不是各次之和。
+// 底层是 Storage::getInstance() 选定的后端，MySQL 后端的并发查询各自借用不同的连接。
+// 只提供确实并发使用的调用（Client::getUser() 同时读用户和任务列表），其余操作走同步的 Storage 接口。
+class AsyncDatabase {
+public:
+    AsyncDatabase(const AsyncDatabase&) = delete;
+    AsyncDatabase& operator=(const AsyncDatabase&) = delete;
+
+    static AsyncDatabase& getInstance();
+
+    std::future<std::vector<Task>> getUserTasks(int id);
+    // 查询失败时返回的 User.id 与 id 不同
+    std::future<User> getUser(int id);
+
+private:
+    AsyncDatabase();
+    ~AsyncDatabase() = default;
+
+    Storage &data_;
+    std::unique_ptr<DbExecutor> executor_;
+};
+
+#endif // ASYNC_DATABASE_H
@@ -0,0 +1,26 @@
+// AuthContext.cpp
+#include "AuthContext.h"
+
+namespace {
+
+thread_local TokenClaims tlsClaims;
+thread_local bool tlsAuthenticated = false;
+
+} // namespace
+
+void AuthContext::reset() {
+    tlsAuthenticated = false;
+}
+
+void AuthContext::set(const TokenClaims &claims) {
+    tlsClaims = claims;
+    tlsAuthenticated = true;
+}
+
+const TokenClaims *AuthContext::current() {
+    return tlsAuthenticated ? &tlsClaims : nullptr;
+}
+
+int AuthContext::userId() {
+    return tlsAuthenticated ? tlsClaims.userId : -1;
+}
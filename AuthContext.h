@@ -0,0 +1,23 @@
+// AuthContext.h
+#ifndef AUTH_CONTEXT_H
+#define AUTH_CONTEXT_H
+
+#include "TokenCache.h"
+
+// 当前请求的认证信息。pre-routing 校验 token 时写入一次，处理函数直接读取，
+// 不再重复解析 Authorization 头、解码 token。
+// httplib 在同一个工作线程上依次调用 pre-routing、路由处理函数和 post-routing，
+// 所以用线程局部变量保存（与 AdmissionController 记录名额的方式相同）。
+class AuthContext {
+public:
+    // 每个请求开始时调用，清掉同一线程上一个请求留下的信息
+    static void reset();
+    static void set(const TokenClaims &claims);
+
+    // 未经认证的请求（静态文件、公开 API）返回 nullptr
+    static const TokenClaims *current();
+    // 没有认证信息时返回 -1
+    static int userId();
+};
+
+#endif // AUTH_CONTEXT_H
@@ -0,0 +1,122 @@
+// Client.cpp
+#include "Client.h"
+#include "AsyncDatabase.h"
+#include "Logger.h"
+#include <future>
+#include <chrono>
+
+Client::Client()
+    : id(-1), valid(false), data(Storage::getInstance()),
+      version_(std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count()) {
+    data.connect();
+}
+
+int Client::getIdByName(const std::string &username) {
+    return data.getIdByName(username);
+}
+
+bool Client::registerUser(const std::string &username, const std::string &email, const std::string &password) {
+    bool res = data.registerUser(username, email, password);
+    if (res == true) {
+        id = getIdByName(username);
+        valid = true;
+        user = data.getUser(username);
+    }
+    return res;
+}
+
+bool Client::loginUser(const std::string &username, const std::string &password) {
+    LOG_DEBUG("loginUser: " << username);
+    bool res = data.loginUser(username, password, user);
+    if (res == true) {
+        id = user.id;
+        valid = true;
+    }
+    return res;
+}
+
+bool Client::restore(int userId) {
+    User u = data.getUser(userId);
+    if (u.id != userId) {
+        return false;
+    }
+    user = u;
+    id = userId;
+    valid = true;
+    return true;
+}
+
+int Client::addTask(int id, const Task &t) {
+    LOG_DEBUG("addTask: " << id);
+    return data.addTask(id, t);
+}
+
+bool Client::delTask(int taskId) {
+    LOG_DEBUG("delTask: " << taskId);
+    return data.delTask(id, taskId);
+}
+
+bool Client::updateTaskStatus(int taskId, bool completed) {
+    LOG_DEBUG("updateTaskStatus: " << taskId << " :" << completed);
+    return data.updateTaskStatus(id, taskId, completed);
+}
+
+bool Client::getTask(int taskId, Task &task) {
+    if (valid == true) {
+        return data.getTask(id, taskId, task);
+    }
+    return false;
+}
+
+bool Client::applyTaskBatch(const std::vector<TaskOp> &ops, std::vector<TaskOpResult> &results) {
+    if (valid == true) {
+        LOG_DEBUG("applyTaskBatch: " << ops.size());
+        return data.applyTaskBatch(id, ops, results);
+    }
+    return false;
+}
+
+std::vector<Task> Client::getUserTasks(int id) {
+    if (valid == true) {
+        return data.getUserTasks(id);
+    }
+    return std::vector<Task>();
+}
+
+PageResult Client::getUserTasksPage(size_t limit, const std::string &after, TaskPage &page) {
+    if (valid == true) {
+        return data.getUserTasksPage(id, limit, after, page);
+    }
+    return PageResult::Error;
+}
+
+bool Client::streamUserTasks(const std::function<bool(const Task&)> &onTask) {
+    if (valid == true) {
+        return data.streamUserTasks(id, onTask);
+    }
+    return false;
+}
+
+User Client::getUser(const std::string &username) {
+    if (valid == true) {
+        user = data.getUser(username);
+        user.task = getUserTasks(user.id);
+    }
+    return user;
+}
+
+User Client::getUser() {
+    if (valid != true) {
+        return user;
+    }
+    AsyncDatabase &async = AsyncDatabase::getInstance();
+    std::future<User> userFuture = async.getUser(id);
+    std::future<std::vector<Task>> tasksFuture = async.getUserTasks(id);
+    User current = userFuture.get();
+    if (current.id != id) {
+        current = user;     // 查询失败时退回登录时缓存的用户信息
+    }
+    current.task = tasksFuture.get();
+    return current;
+}
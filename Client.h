@@ -0,0 +1,64 @@
+// Client.h
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include "Storage.h"
+
+// 一个已登录用户的会话，保存在 SessionRegistry 中
+class Client {
+public:
+    Client();
+    ~Client() {}
+
+    int getIdByName(const std::string &username);
+    bool registerUser(const std::string &username, const std::string &email, const std::string &password);
+
+    // 登录只查一次用户表，任务列表等到真正需要时再加载
+    bool loginUser(const std::string &username, const std::string &password);
+
+    int addTask(int id, const Task &t);
+    bool delTask(int taskId);
+    bool updateTaskStatus(int taskId, bool completed);
+    bool getTask(int taskId, Task &task);
+    bool applyTaskBatch(const std::vector<TaskOp> &ops, std::vector<TaskOpResult> &results);
+    std::vector<Task> getUserTasks(int id);
+    PageResult getUserTasksPage(size_t limit, const std::string &after, TaskPage &page);
+    bool streamUserTasks(const std::function<bool(const Task&)> &onTask);
+
+    User getUser(const std::string &username);
+    // 读取最新的用户信息和任务列表（/api/profile）。两个查询互不依赖，
+    // 通过 AsyncDatabase 同时发出再一起等待；结果只在返回值里，不改动会话中缓存的 user
+    User getUser();
+
+    // 会话被淘汰后凭 token 里的用户ID重建，用户已不存在时返回 false
+    bool restore(int userId);
+
+    // 任务列表的版本号，每次增删改后加一。前端在本地修补列表，
+    // 收到的版本号不是本地版本号 + 1 时说明漏了变更（多端同时修改），再整体刷新。
+    // 初值取当前毫秒时间戳，会话被淘汰重建后版本号仍然比之前的大。
+    uint64_t version() const {
+        return version_.load(std::memory_order_acquire);
+    }
+    uint64_t bumpVersion() {
+        return version_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+
+    // 登录后缓存的用户信息，不触发任务查询
+    const User &getLoginUser() const {
+        return user;
+    }
+
+private:
+    int id;
+    bool valid;
+    Storage &data;
+    User user;
+    std::atomic<uint64_t> version_;
+};
+
+#endif // CLIENT_H
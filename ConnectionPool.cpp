@@ -0,0 +1,323 @@
+// ConnectionPool.cpp
+#include "ConnectionPool.h"
+#include "Metrics.h"
+#include <iostream>
+#include <vector>
+
+using mysqlx::SessionSettings;
+using mysqlx::SessionOption;
+
+using Clock = std::chrono::steady_clock;
+
+PooledConnection::PooledConnection(const PoolConfig &config)
+    : lastUsed(Clock::now()),
+      database_(config.database),
+      session_(SessionSettings(
+          SessionOption::HOST, config.host,
+          SessionOption::PORT, config.port,
+          SessionOption::USER, config.user,
+          SessionOption::PWD, config.password,
+          SessionOption::DB, config.database)) {
+}
+
+PooledConnection::~PooledConnection() {
+    statements_.reset();
+    try {
+        session_.close();
+    } catch (const mysqlx::Error &e) {
+        std::cerr << "关闭数据库连接失败: " << e.what() << std::endl;
+    }
+}
+
+StatementCache &PooledConnection::statements() {
+    if (!statements_) {
+        statements_.reset(new StatementCache(session_, database_));
+    }
+    return *statements_;
+}
+
+bool PooledConnection::ping() {
+    try {
+        session_.sql("SELECT 1").execute();
+        return true;
+    } catch (const mysqlx::Error &e) {
+        std::cerr << "连接健康检查失败: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+ConnectionPool::Lease::Lease(Lease &&other) noexcept
+    : pool_(other.pool_), conn_(std::move(other.conn_)), broken_(other.broken_),
+      suspect_(other.suspect_), uncaught_(other.uncaught_) {
+    other.pool_ = nullptr;
+}
+
+ConnectionPool::Lease &ConnectionPool::Lease::operator=(Lease &&other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        conn_ = std::move(other.conn_);
+        broken_ = other.broken_;
+        suspect_ = other.suspect_;
+        uncaught_ = other.uncaught_;
+        other.pool_ = nullptr;
+    }
+    return *this;
+}
+
+ConnectionPool::Lease::~Lease() {
+    if (std::uncaught_exceptions() > uncaught_) {
+        suspect_ = true;
+    }
+    release();
+}
+
+void ConnectionPool::Lease::release() {
+    if (pool_ && conn_) {
+        pool_->giveBack(std::move(conn_), broken_, suspect_);
+    }
+    pool_ = nullptr;
+}
+
+ConnectionPool& ConnectionPool::getInstance() {
+    static ConnectionPool instance;
+    return instance;
+}
+
+ConnectionPool::ConnectionPool()
+    : running_(false), total_(0), waiting_(0),
+      acquired_(0), timeouts_(0), created_(0), destroyed_(0),
+      healthCheckFailures_(0), waitTimeTotalUs_(0), waitTimeMaxUs_(0) {
+}
+
+ConnectionPool::~ConnectionPool() {
+    shutdown();
+}
+
+bool ConnectionPool::initialize(const PoolConfig &config) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (running_) {
+        return true;
+    }
+    config_ = config;
+    if (config_.maxSize == 0) {
+        config_.maxSize = 1;
+    }
+    if (config_.minSize > config_.maxSize) {
+        config_.minSize = config_.maxSize;
+    }
+
+    // 预先建立 minSize 条连接，连不上数据库时直接抛出，和原来 connect() 的行为一致
+    try {
+        while (idle_.size() < config_.minSize) {
+            idle_.push_back(createConnection());
+            total_++;
+        }
+    } catch (const mysqlx::Error &e) {
+        std::cerr << "数据库连接错误: " << e.what() << std::endl;
+        std::deque<std::unique_ptr<PooledConnection>> failed;
+        failed.swap(idle_);
+        destroyed_ += failed.size();
+        total_ = 0;
+        throw;
+    }
+
+    running_ = true;
+    reaper_ = std::thread(&ConnectionPool::reaperLoop, this);
+    std::cerr << "数据库连接池已启动: min=" << config_.minSize
+              << ", max=" << config_.maxSize << std::endl;
+    return true;
+}
+
+void ConnectionPool::shutdown() {
+    std::deque<std::unique_ptr<PooledConnection>> closing;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        closing.swap(idle_);
+        total_ -= closing.size();
+    }
+    available_.notify_all();
+    reaperWake_.notify_all();
+    if (reaper_.joinable()) {
+        reaper_.join();
+    }
+    destroyed_ += closing.size();
+    // 借出中的连接会在归还时因 running_ == false 被销毁
+}
+
+std::unique_ptr<PooledConnection> ConnectionPool::createConnection() {
+    std::unique_ptr<PooledConnection> conn(new PooledConnection(config_));
+    created_++;
+    return conn;
+}
+
+void ConnectionPool::destroy(std::unique_ptr<PooledConnection> conn) {
+    conn.reset();
+    destroyed_++;
+}
+
+ConnectionPool::Lease ConnectionPool::acquire() {
+    const auto start = Clock::now();
+    const auto deadline = start + config_.acquireTimeout;
+    std::unique_ptr<PooledConnection> conn;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    waiting_++;
+    while (!conn) {
+        if (!running_) {
+            waiting_--;
+            throw mysqlx::Error("数据库连接池未启动");
+        }
+        if (!idle_.empty()) {
+            // 后进先出，优先复用最近用过的热连接，冷连接留给回收线程
+            conn = std::move(idle_.back());
+            idle_.pop_back();
+            break;
+        }
+        if (total_ < config_.maxSize) {
+            // 先占名额再解锁建连，避免并发超出上限
+            total_++;
+            lock.unlock();
+            try {
+                conn = createConnection();
+            } catch (...) {
+                lock.lock();
+                total_--;
+                waiting_--;
+                available_.notify_one();
+                throw;
+            }
+            lock.lock();
+            break;
+        }
+        if (available_.wait_until(lock, deadline) == std::cv_status::timeout &&
+            idle_.empty() && total_ >= config_.maxSize) {
+            waiting_--;
+            timeouts_++;
+            recordWait(Clock::now() - start);
+            throw mysqlx::Error("获取数据库连接超时");
+        }
+    }
+    waiting_--;
+    lock.unlock();
+
+    // 空闲较久的连接可能已被服务端断开，借出前先做健康检查，失败则重建
+    if (Clock::now() - conn->lastUsed >= config_.healthCheckInterval && !conn->ping()) {
+        healthCheckFailures_++;
+        destroy(std::move(conn));
+        try {
+            conn = createConnection();
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(mutex_);
+            total_--;
+            available_.notify_one();
+            throw;
+        }
+    }
+
+    acquired_++;
+    recordWait(Clock::now() - start);
+    return Lease(this, std::move(conn));
+}
+
+void ConnectionPool::giveBack(std::unique_ptr<PooledConnection> conn, bool broken, bool suspect) {
+    // 出过错的连接在放回前检查一次。ping 要走一次网络，放在锁外
+    if (suspect && !broken && running_ && !conn->ping()) {
+        healthCheckFailures_++;
+        broken = true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_ && !broken) {
+            conn->lastUsed = Clock::now();
+            idle_.push_back(std::move(conn));
+        } else {
+            total_--;
+        }
+    }
+    available_.notify_one();
+    if (conn) {
+        destroy(std::move(conn));
+    }
+}
+
+void ConnectionPool::recordWait(Clock::duration waited) {
+    static Histogram &waitHistogram = Metrics::getInstance().histogram(
+        "todo_db_pool_acquire_wait_seconds", "Time spent waiting to borrow a database connection");
+    waitHistogram.observe(waited);
+    uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(waited).count();
+    waitTimeTotalUs_ += us;
+    uint64_t prev = waitTimeMaxUs_.load(std::memory_order_relaxed);
+    while (us > prev && !waitTimeMaxUs_.compare_exchange_weak(prev, us, std::memory_order_relaxed)) {
+    }
+}
+
+// 回收线程：关闭超过 maxIdleTime 的多余空闲连接，并把池子补到 minSize
+void ConnectionPool::reaperLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        reaperWake_.wait_for(lock, config_.reapInterval);
+        if (!running_) {
+            break;
+        }
+
+        std::vector<std::unique_ptr<PooledConnection>> expired;
+        const auto now = Clock::now();
+        // idle_ 头部是最久未用的连接
+        while (total_ > config_.minSize && !idle_.empty() &&
+               now - idle_.front()->lastUsed >= config_.maxIdleTime) {
+            expired.push_back(std::move(idle_.front()));
+            idle_.pop_front();
+            total_--;
+        }
+
+        size_t missing = total_ < config_.minSize ? config_.minSize - total_ : 0;
+        total_ += missing;
+        lock.unlock();
+
+        for (auto &conn : expired) {
+            destroy(std::move(conn));
+        }
+        std::vector<std::unique_ptr<PooledConnection>> fresh;
+        for (size_t i = 0; i < missing; i++) {
+            try {
+                fresh.push_back(createConnection());
+            } catch (const mysqlx::Error &e) {
+                std::cerr << "补充数据库连接失败: " << e.what() << std::endl;
+                break;
+            }
+        }
+
+        lock.lock();
+        total_ -= missing - fresh.size();
+        for (auto &conn : fresh) {
+            idle_.push_back(std::move(conn));
+        }
+        if (!fresh.empty()) {
+            available_.notify_all();
+        }
+    }
+}
+
+PoolStats ConnectionPool::stats() const {
+    PoolStats s;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        s.total = total_;
+        s.idle = idle_.size();
+        s.inUse = total_ - idle_.size();
+        s.waiting = waiting_;
+    }
+    s.acquired = acquired_;
+    s.timeouts = timeouts_;
+    s.created = created_;
+    s.destroyed = destroyed_;
+    s.healthCheckFailures = healthCheckFailures_;
+    s.waitTimeTotalUs = waitTimeTotalUs_;
+    s.waitTimeMaxUs = waitTimeMaxUs_;
+    return s;
+}
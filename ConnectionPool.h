@@ -0,0 +1,151 @@
+// ConnectionPool.h
+#ifndef CONNECTION_POOL_H
+#define CONNECTION_POOL_H
+
+#include <string>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mysqlx/xdevapi.h>
+#include "StatementCache.h"
+
+// 连接池配置
+struct PoolConfig {
+    std::string host = "localhost";
+    int port = 33060;
+    std::string user = "root";
+    std::string password = "1234";
+    std::string database = "todo_app";
+
+    size_t minSize = 2;                                  // 常驻的最少连接数
+    size_t maxSize = 16;                                 // 连接数上限
+    std::chrono::milliseconds acquireTimeout{5000};      // 借连接的最长等待时间
+    std::chrono::seconds maxIdleTime{60};                // 超过 minSize 的空闲连接存活时间
+    std::chrono::seconds healthCheckInterval{30};        // 空闲超过该时间的连接借出前先 ping
+    std::chrono::seconds reapInterval{10};               // 后台回收线程的扫描周期
+};
+
+// 连接池运行指标快照
+struct PoolStats {
+    size_t total = 0;         // 当前存活连接（空闲 + 借出）
+    size_t idle = 0;
+    size_t inUse = 0;
+    size_t waiting = 0;       // 正在排队等待连接的线程数
+    uint64_t acquired = 0;    // 累计借出次数
+    uint64_t timeouts = 0;    // 累计等待超时次数
+    uint64_t created = 0;
+    uint64_t destroyed = 0;
+    uint64_t healthCheckFailures = 0;
+    uint64_t waitTimeTotalUs = 0;
+    uint64_t waitTimeMaxUs = 0;
+};
+
+// 池中的一条物理连接
+class PooledConnection {
+public:
+    explicit PooledConnection(const PoolConfig &config);
+    ~PooledConnection();
+
+    mysqlx::Session &session() { return session_; }
+
+    // 该连接上缓存的表句柄和语句，第一次使用时创建
+    StatementCache &statements();
+
+    // 执行 SELECT 1 检查连接是否可用
+    bool ping();
+
+    std::chrono::steady_clock::time_point lastUsed;
+
+private:
+    std::string database_;
+    mysqlx::Session session_;
+    std::unique_ptr<StatementCache> statements_;   // 依赖 session_，必须声明在其后
+};
+
+class ConnectionPool {
+public:
+    // 借出的连接，析构时自动归还。
+    // 因异常离开作用域时（连接断开、MySQL 重启等都会以 mysqlx::Error 抛出），
+    // 归还前先 ping 一次，不可用的连接直接销毁，不会再被借出去
+    class Lease {
+    public:
+        Lease() : pool_(nullptr) {}
+        Lease(ConnectionPool *pool, std::unique_ptr<PooledConnection> conn)
+            : pool_(pool), conn_(std::move(conn)), broken_(false), suspect_(false),
+              uncaught_(std::uncaught_exceptions()) {}
+        Lease(Lease &&other) noexcept;
+        Lease &operator=(Lease &&other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease &operator=(const Lease&) = delete;
+        ~Lease();
+
+        mysqlx::Session *operator->() { return &conn_->session(); }
+        mysqlx::Session &operator*() { return conn_->session(); }
+        PooledConnection &connection() { return *conn_; }
+
+        // 标记连接已损坏，归还时直接销毁而不放回池中
+        void invalidate() { broken_ = true; }
+        // 标记连接出过错，归还时先做健康检查
+        void markSuspect() { suspect_ = true; }
+        void release();
+
+    private:
+        ConnectionPool *pool_;
+        std::unique_ptr<PooledConnection> conn_;
+        bool broken_ = false;
+        bool suspect_ = false;
+        int uncaught_ = 0;        // 借出时正在传播的异常数，析构时更多说明是因异常退出
+    };
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    static ConnectionPool& getInstance();
+
+    // 建立 minSize 条连接并启动回收线程（重复调用直接返回）
+    bool initialize(const PoolConfig &config);
+    void shutdown();
+    bool isRunning() const { return running_; }
+    const PoolConfig &config() const { return config_; }
+
+    // 借一条连接，等待超过 acquireTimeout 抛出 mysqlx::Error
+    Lease acquire();
+
+    PoolStats stats() const;
+
+private:
+    ConnectionPool();
+    ~ConnectionPool();
+
+    std::unique_ptr<PooledConnection> createConnection();
+    void giveBack(std::unique_ptr<PooledConnection> conn, bool broken, bool suspect);
+    void destroy(std::unique_ptr<PooledConnection> conn);
+    void reaperLoop();
+    void recordWait(std::chrono::steady_clock::duration waited);
+
+    PoolConfig config_;
+    std::atomic<bool> running_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;   // 有连接归还或名额空出
+    std::condition_variable reaperWake_;
+    std::deque<std::unique_ptr<PooledConnection>> idle_;
+    size_t total_;
+    size_t waiting_;
+    std::thread reaper_;
+
+    std::atomic<uint64_t> acquired_;
+    std::atomic<uint64_t> timeouts_;
+    std::atomic<uint64_t> created_;
+    std::atomic<uint64_t> destroyed_;
+    std::atomic<uint64_t> healthCheckFailures_;
+    std::atomic<uint64_t> waitTimeTotalUs_;
+    std::atomic<uint64_t> waitTimeMaxUs_;
+};
+
+#endif // CONNECTION_POOL_H
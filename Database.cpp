@@ -3,30 +3,33 @@
 #include <mysqlx/xdevapi.h>
 #include "PasswordHasher.h"
 #include "Database.h"
+#include "ConnectionPool.h"
+#include "TaskCache.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include <unordered_map>
+#include <unordered_set>
 
 // 使用命名空间，但避免 using namespace std; 以免冲突
 using mysqlx::Session;
-using mysqlx::SessionSettings;
-using mysqlx::SessionOption;
 using mysqlx::Schema;
 using mysqlx::Table;
 using mysqlx::Row;
+using mysqlx::RowResult;
 using mysqlx::SqlResult;
 
-// 使用 std:: 前缀明确指定标准库
-using std::cout;
-using std::cerr;
-using std::endl;
-using std::cin;
+// 按方法统计的数据库调用耗时，包括借连接的等待时间
+static Histogram &queryLatency(const char *method) {
+    return Metrics::getInstance().histogram("todo_db_query_duration_seconds",
+                                            "Database call latency by method, including pool wait",
+                                            {{"method", method}});
+}
 
-// 数据库配置
-const std::string HOST = "localhost";
-const int PORT = 33060;
-const std::string USER = "root";
-const std::string PASSWORD = "1234";
-const std::string DATABASE = "todo_app";
+#define DB_TIMED(method) \
+    static Histogram &db_latency_ = queryLatency(method); \
+    ScopedTimer db_timer_(db_latency_)
 
-Database::Database() : session_(nullptr), connected_(false) {
+Database::Database() : connected_(false) {
 
 }
 
@@ -34,270 +37,409 @@ Database::~Database() {
     disconnect();
 }
 
-// 创建 Session（数据库连接）
+// 连接由进程级连接池统一管理，这里只确保连接池已启动（默认配置）
 bool Database::connect() {
-    bool ret = false;
-    try {
-        SessionSettings settings(
-            SessionOption::HOST, HOST,
-            SessionOption::PORT, PORT,
-            SessionOption::USER, USER,
-            SessionOption::PWD, PASSWORD,
-            SessionOption::DB, DATABASE
-        );
-        std::unique_ptr<Session> s(new Session(settings));
-        session_.swap(s);
-        connected_ =  true;
-        cerr << "数据库连接成功: " << endl;
-        ret = true;
-    } catch (const mysqlx::Error &e) {
-        cerr << "数据库连接错误: " << e.what() << endl;
-        throw;
+    ConnectionPool &pool = ConnectionPool::getInstance();
+    if (!pool.isRunning()) {
+        pool.initialize(PoolConfig());
     }
-    return ret;
+    connected_ = pool.isRunning();
+    return connected_;
 }
 
 void Database::disconnect() {
-    if (session_) {
-        session_->close();
-        session_.reset();
-    }
     connected_ = false;
 }
 
 // 用户注册
 bool Database::registerUser(const std::string &username, const std::string &email, const std::string &password) {
+    DB_TIMED("registerUser");
     if (!connected_) {
         return false;
     }
 
     try {
-        Schema db = session_->getSchema(DATABASE);
-        Table users = db.getTable("users");
+        // 检查密码
+        PasswordHasher& hasher = PasswordHasher::getInstance();
+
+        // 检查密码强度
+        if (!hasher.isPasswordStrong(password)) {
+            LOG_WARN("警告: 密码安全等级较低!");
+        }
+
+        // 哈希密码（Argon2 较慢，放在借连接之前，避免长时间占用池中的连接）
+        std::string hashedPassword = hasher.hashPassword(password);
+
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
 
         // 检查用户名是否已存在
-        auto result = users.select("id")
-                       .where("username = :username OR email = :email")
+        auto result = stmt.userExists
                        .bind("username", username)
                        .bind("email", email)
                        .execute();
 
         if (result.count() > 0) {
-            cout << "错误: 用户名或邮箱已存在!" << endl;
+            LOG_WARN("错误: 用户名或邮箱已存在!");
             return false;
         }
 
-        // 检查密码
-        PasswordHasher& hasher = PasswordHasher::getInstance();
-
-        // 检查密码强度
-        if (!hasher.isPasswordStrong(password)) {
-            cout << "警告: 密码安全等级较低!" << endl;
-        }
-
-        // 哈希密码
-        std::string hashedPassword = hasher.hashPassword(password);
-
         // 插入新用户
-        users.insert("username", "email", "password_hash")
+        stmt.users.insert("username", "email", "password_hash")
               .values(username, email, hashedPassword)
               .execute();
 
-        cout << "用户注册成功!" << endl;
+        LOG_INFO("用户注册成功!");
         return true;
 
     } catch (const mysqlx::Error &e) {
-        cerr << "注册失败: " << e.what() << endl;
+        LOG_ERROR("注册失败: " << e.what());
         return false;
     }
 }
 
-// 用户登录验证
-bool Database::loginUser(const std::string &username, const std::string &password) {
+// 用户登录验证：一次查询取回用户行和密码哈希，成功时填充 user（不加载任务列表）
+bool Database::loginUser(const std::string &username, const std::string &password, User &user) {
+    DB_TIMED("loginUser");
     if (!connected_) {
         return false;
     }
 
     try {
-        Schema db = session_->getSchema(DATABASE);
-        Table users = db.getTable("users");
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
 
         // 查询用户信息
-        auto result = users.select("id", "password_hash")
-                       .where("username = :username")
+        auto result = stmt.userByName
                        .bind("username", username)
                        .execute();
 
         if (result.count() == 0) {
-            cout << "错误: 用户不存在!" << endl;
+            LOG_WARN("错误: 用户不存在!");
             return false;
         }
 
         Row row = result.fetchOne();
         // 使用正确的 getter 方法
-        std::string storedPassword = row[1].get<std::string>();
+        User found;
+        found.id            = row[0].get<int>();
+        found.username      = row[1].get<std::string>();
+        found.email         = row[2].get<std::string>();
+        found.password_hash = row[3].get<std::string>();
+        found.timestamp     = row[4].get<std::string>();
+        // 校验密码不需要数据库，先把连接还给连接池
+        session.release();
 
          // 检查密码
         PasswordHasher& hasher = PasswordHasher::getInstance();
-        if (hasher.verifyPassword(storedPassword, password)) {
-            int userId = row[0].get<int>();
-            cout << "登录成功! 用户ID: " << userId << endl;
+        if (hasher.verifyPassword(found.password_hash, password)) {
+            LOG_INFO("登录成功! 用户ID: " << found.id);
+            user = found;
             return true;
         } else {
-            cout << "错误: 密码不正确!" << endl;
+            LOG_WARN("错误: 密码不正确!");
             return false;
         }
 
     } catch (const mysqlx::Error &e) {
-        cerr << "登录失败: " << e.what() << endl;
+        LOG_ERROR("登录失败: " << e.what());
         return false;
     }
 }
 
-bool Database::addTask(int id, const Task &t) {
-    bool ret = false;
-    if (!connected_) {
-        return ret;
+// 添加单个任务，返回新任务ID，失败返回 -1
+int Database::addTask(int id, const Task &t) {
+    std::vector<int> ids = addTasks(id, std::vector<Task>{t});
+    return ids.empty() ? -1 : ids[0];
+}
+
+// 所有行放在一条多行 INSERT 里一次发出，
+// 新ID由本次插入结果中的首个自增值推算，不再额外查询 LAST_INSERT_ID()
+static std::vector<int> insertTaskRows(StatementCache &stmt, int userId, const std::vector<Task> &tasks) {
+    // INSERT 每次的值都不同，只复用表句柄
+    mysqlx::TableInsert insert = stmt.tasks.insert(
+          "title", "description", "completed", "due_date", "user_id");
+    for (const Task &t : tasks) {
+        // 没有截止时间时写 NULL，而不是空字符串
+        mysqlx::Value due = t.datetime.empty() ? mysqlx::Value() : mysqlx::Value(t.datetime);
+        insert.values(t.title, t.text, t.completed, due, userId);
+    }
+    mysqlx::Result result = insert.execute();
+
+    // 单条多行 INSERT 属于 simple insert，InnoDB 为其分配连续的自增值，
+    // 步长为 auto_increment_increment
+    std::vector<int> ids;
+    int64_t firstId = static_cast<int64_t>(result.getAutoIncrementValue());
+    for (size_t i = 0; i < tasks.size(); i++) {
+        ids.push_back(static_cast<int>(firstId + static_cast<int64_t>(i) * stmt.autoIncrementStep));
     }
+    return ids;
+}
 
-    try {
-        Schema db = session_->getSchema(DATABASE);
-        Table tasks = db.getTable("tasks");
+// 任务ID列表拼成 IN (...) 的内容，都是整数，不存在注入问题
+static std::string idList(const std::vector<int> &ids) {
+    std::string list;
+    for (int id : ids) {
+        list += (list.empty() ? "" : ",") + std::to_string(id);
+    }
+    return list;
+}
 
-        tasks.insert(
-              "title", "description", "completed", "due_date", "user_id")
-              .values(t.title, t.text, t.completed, t.datetime, id)
-              .execute();
+// 批量添加任务
+std::vector<int> Database::addTasks(int id, const std::vector<Task> &tasks) {
+    DB_TIMED("addTasks");
+    std::vector<int> ret;
+    if (!connected_ || tasks.empty()) {
+        return ret;
+    }
 
-        cout << "\n=== " << id << " 添加任务 ===" << endl;
+    try {
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
 
-        // 获取最后插入的ID
-        SqlResult sqlResult = session_->sql("SELECT LAST_INSERT_ID()").execute();
-        Row row = sqlResult.fetchOne();
-        int generatedId = row[0];
+        ret = insertTaskRows(stmt, id, tasks);
 
-        std::cout << "Task inserted with ID: " << generatedId << std::endl;
+        // 新任务的 created_at 由数据库生成，缓存无法就地补上，直接失效
+        TaskCache::getInstance().invalidate(id);
 
-        return generatedId;
+        LOG_DEBUG("用户 " << id << " 添加任务 " << tasks.size() << " 条, 首个ID: " << ret[0]);
     } catch (const mysqlx::Error &e) {
-        cerr << "添加任务失败: " << e.what() << endl;
+        LOG_ERROR("添加任务失败: " << e.what());
+        ret.clear();
     }
     return ret;
 }
 
-// 删除任务
-bool Database::delTask(int taskId) {
+// 删除任务（只能删除属于该用户的任务）
+bool Database::delTask(int userId, int taskId) {
+    DB_TIMED("delTask");
     bool ret = false;
     if (!connected_) {
         return ret;
     }
 
     try {
-        Schema db = session_->getSchema(DATABASE);
-        Table tasks = db.getTable("tasks");
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
 
-        mysqlx::Result result = tasks.remove()
-                              .where("id = :id")
+        mysqlx::Result result = stmt.deleteTask
                               .bind("id", taskId)
+                              .bind("user_id", userId)
                               .execute();
 
-            std::cout << "Task " << taskId << " deleted. Affected rows: "
-                      << result.getAffectedItemsCount() << std::endl;
-            return result.getAffectedItemsCount() > 0;
+            LOG_DEBUG("Task " << taskId << " deleted. Affected rows: " << result.getAffectedItemsCount());
+            if (result.getAffectedItemsCount() == 0) {
+                return false;
+            }
+            TaskCache::getInstance().removeTask(userId, taskId);
+            return true;
 
     } catch (const mysqlx::Error &e) {
-        cerr << "删除任务失败: " << e.what() << endl;
+        LOG_ERROR("删除任务失败: " << e.what());
     }
     return ret;
 }
 
-// 更新任务状态
-bool Database::updateTaskStatus(int taskId, bool completed) {
+// 更新任务状态（只能更新属于该用户的任务）
+bool Database::updateTaskStatus(int userId, int taskId, bool completed) {
+    DB_TIMED("updateTaskStatus");
     bool ret = false;
     if (!connected_) {
         return ret;
     }
     try {
-        Schema db = session_->getSchema(DATABASE);
-        Table tasks = db.getTable("tasks");
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
 
-        mysqlx::Result result = tasks.update()
-                            .set("completed", completed)
-                            .where("id = :id")
+        mysqlx::Result result = stmt.updateTaskStatus
+                            .bind("completed", completed)
                             .bind("id", taskId)
+                            .bind("user_id", userId)
                             .execute();
 
-        std::cout << "Task " << taskId << " updated. Affected rows: "
-                    << result.getAffectedItemsCount() << std::endl;
-        return result.getAffectedItemsCount() > 0;
+        uint64_t affected = result.getAffectedItemsCount();
+        LOG_DEBUG("Task " << taskId << " updated. Affected rows: " << affected);
+        // 只有确实改了一行才修改缓存。affected rows 为 0 可能是任务不存在（不属于该用户），
+        // 也可能是状态本来就相同，分不清，整项失效让下次读取回源
+        if (affected > 0) {
+            TaskCache::getInstance().setTaskCompleted(userId, taskId, completed);
+        } else {
+            TaskCache::getInstance().invalidate(userId);
+        }
+        return affected > 0;
     } catch (const mysqlx::Error &e) {
-        std::cerr << "更新任务失败: " << e.what() << std::endl;
+        LOG_ERROR("更新任务失败: " << e.what());
+        // 不知道语句是否已经生效
+        TaskCache::getInstance().invalidate(userId);
         return false;
     }
 }
 
-// 获取用户的任务列表
+// 把 tasks 查询结果中的一行转成 Task，列顺序见 StatementCache 中的任务查询
+static Task rowToTask(Row &row) {
+    // 使用正确的 getter 方法，due_date 可能为 NULL
+    Task task;
+    task.id        = row[0].get<int>();
+    task.title     = row[1].get<std::string>();
+    task.text      = row[2].isNull() ? std::string() : row[2].get<std::string>();
+    task.completed = row[3].get<bool>();
+    task.datetime  = row[4].isNull() ? std::string() : row[4].get<std::string>();
+    task.timestamp = row[5].get<std::string>();
+    return task;
+}
+
+bool Database::getTask(int userId, int taskId, Task &task) {
+    DB_TIMED("getTask");
+    if (!connected_) {
+        return false;
+    }
+
+    try {
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
+
+        RowResult result = stmt.taskById
+            .bind("id", taskId)
+            .bind("user_id", userId)
+            .execute();
+        Row row = result.fetchOne();
+        if (!row) {
+            return false;
+        }
+        task = rowToTask(row);
+        return true;
+    } catch (const mysqlx::Error &e) {
+        LOG_ERROR("获取任务失败: " << e.what());
+    }
+    return false;
+}
+
+// 获取用户的任务列表，先查 TaskCache，未命中再回源数据库
 std::vector<Task> Database::getUserTasks(int id) {
     std::vector<Task> ret;
     if (!connected_) {
         return ret;
     }
 
-    try {
-        Schema db = session_->getSchema(DATABASE);
+    TaskCache &cache = TaskCache::getInstance();
+    if (TaskCache::TaskList cached = cache.get(id)) {
+        return *cached;
+    }
+    // 只统计回源数据库的调用，缓存命中不计入
+    DB_TIMED("getUserTasks");
 
-        // 使用 SQL 语句进行复杂查询
-        SqlResult result = session_->sql(
-            "SELECT t.id, t.title, t.description, t.completed, "
-            "CAST(t.due_date AS char), CAST(t.created_at AS char) FROM tasks t "
-            "JOIN users u ON t.user_id = u.id "
-            "WHERE u.id = ? "
-            "ORDER BY t.created_at DESC"
-        ).bind(id).execute();
+    bool ok = false;
+    cache.beginLoad(id);
+    try {
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
 
-        cout << "\n=== " << id << "的任务列表 ===" << endl;
+        // tasks.user_id 就是要过滤的用户ID，直接查 tasks 表，不再 JOIN users
+        RowResult result = stmt.tasksByUser
+            .bind("user_id", id)
+            .execute();
 
         for (Row row : result) {
-            // 使用正确的 getter 方法
-            Task task;
-            task.id        = row[0].get<int>();
-            task.title     = row[1].get<std::string>();
-            task.text      = row[2].get<std::string>();
-            task.completed = row[3].get<bool>();
-            task.datetime  = row[4].get<std::string>();
-            task.timestamp = row[5].get<std::string>();
-            ret.push_back(task);
-            cout << "ID: " << row[0].get<int>()
-                 << ", 标题: " << row[1].get<std::string>()
-                 << ", 状态: " << (row[3].get<bool>() ? "已完成" : "未完成")
-                 << " " << task.datetime << " " << task.timestamp
-                 << endl;
+            ret.push_back(rowToTask(row));
         }
+        ok = true;
+        LOG_DEBUG("用户 " << id << " 的任务列表: " << ret.size() << " 条");
 
     } catch (const mysqlx::Error &e) {
-        cerr << "获取任务失败: " << e.what() << endl;
+        LOG_ERROR("获取任务失败: " << e.what());
     }
+    cache.endLoad(id, ret, ok);
     return ret;
 }
 
+// 按键集分页每次读 kStreamBatchSize 行，读完立即归还连接，再把这一批交给 onTask，
+// 所以 onTask 写网络时不占用连接池，慢客户端不会拖住连接。
+// onTask 返回 false 时提前结束（例如客户端已断开）。
+bool Database::streamUserTasks(int id, const std::function<bool(const Task&)> &onTask) {
+    const size_t kStreamBatchSize = 256;
+    TaskPage page;
+    std::string cursor;
+    do {
+        if (getUserTasksPage(id, kStreamBatchSize, cursor, page) != PageResult::Ok) {
+            return false;
+        }
+        for (const Task &task : page.tasks) {
+            if (!onTask(task)) {
+                return true;
+            }
+        }
+        cursor = page.nextCursor;
+    } while (!cursor.empty());
+    return true;
+}
+
+// 按 (created_at, id) 倒序做键集分页：从游标位置直接定位，不用 OFFSET，
+// 翻到多深每页的代价都一样。多取一行用来判断是否还有下一页。
+PageResult Database::getUserTasksPage(int id, size_t limit, const std::string &after, TaskPage &page) {
+    DB_TIMED("getUserTasksPage");
+    page.tasks.clear();
+    page.nextCursor.clear();
+    if (!connected_) {
+        return PageResult::Error;
+    }
+
+    std::string createdAt;
+    int lastId = 0;
+    if (!after.empty() && !decodeTaskCursor(after, createdAt, lastId)) {
+        LOG_WARN("错误: 无效的分页游标");
+        return PageResult::InvalidCursor;
+    }
+
+    try {
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
+
+        RowResult result;
+        if (after.empty()) {
+            result = stmt.tasksPageFirst
+                .bind("user_id", id)
+                .limit(limit + 1)
+                .execute();
+        } else {
+            result = stmt.tasksPageAfter
+                .bind("user_id", id)
+                .bind("created_at", createdAt)
+                .bind("id", lastId)
+                .limit(limit + 1)
+                .execute();
+        }
+
+        for (Row row : result) {
+            if (page.tasks.size() == limit) {
+                page.nextCursor = encodeTaskCursor(page.tasks.back());
+                break;
+            }
+            page.tasks.push_back(rowToTask(row));
+        }
+        return PageResult::Ok;
+    } catch (const mysqlx::Error &e) {
+        LOG_ERROR("获取任务失败: " << e.what());
+    }
+    page.tasks.clear();
+    page.nextCursor.clear();
+    return PageResult::Error;
+}
+
 User Database::getUser(const std::string &username) {
+    DB_TIMED("getUserByName");
     User user;
     if (!connected_) {
-        std::cout << "数据库未连接" << std::endl;
+        LOG_WARN("数据库未连接");
         return user;
     }
 
     try {
-        Schema db = session_->getSchema(DATABASE);
-
-        // 使用 SQL 语句进行复杂查询
-        SqlResult result = session_->sql(
-            "SELECT u.id, u.username, u.email, "
-            "u.password_hash, CAST(u.created_at AS char) FROM users u "
-            "WHERE username = ? "
-        ).bind(username).execute();
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
 
-        cout << "\n=== " << username << "的任务列表 ===" << endl;
+        RowResult result = stmt.userByName
+            .bind("username", username)
+            .execute();
 
         for (Row row : result) {
             // 使用正确的 getter 方法
@@ -306,35 +448,28 @@ User Database::getUser(const std::string &username) {
             user.email        = row[2].get<std::string>();
             user.password_hash= row[3].get<std::string>();
             user.timestamp    = row[4].get<std::string>();
-            cout << "ID: " << row[0].get<int>()
-                 << ", username: " << row[1].get<std::string>()
-                 << ", email: " << (row[2].get<std::string>())
-                 << endl;
         }
 
     } catch (const mysqlx::Error &e) {
-        cerr << "获取任务失败: " << e.what() << endl;
+        LOG_ERROR("获取任务失败: " << e.what());
     }
     return user;
 }
 
 User Database::getUser(int id) {
+    DB_TIMED("getUserById");
     User user;
     if (!connected_) {
         return user;
     }
 
     try {
-        Schema db = session_->getSchema(DATABASE);
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
 
-        // 使用 SQL 语句进行复杂查询
-        SqlResult result = session_->sql(
-            "SELECT u.id, u.username, u.email, "
-            "u.password_hash, CAST(u.created_at AS char) FROM users u "
-            "WHERE id = ? "
-        ).bind(id).execute();
-
-        cout << "\n=== " << id << "的任务列表 ===" << endl;
+        RowResult result = stmt.userById
+            .bind("id", id)
+            .execute();
 
         for (Row row : result) {
             // 使用正确的 getter 方法
@@ -343,36 +478,32 @@ User Database::getUser(int id) {
             user.email        = row[2].get<std::string>();
             user.password_hash= row[3].get<std::string>();
             user.timestamp    = row[4].get<std::string>();
-            cout << "ID: " << row[0].get<int>()
-                 << ", username: " << row[1].get<std::string>()
-                 << ", email: " << (row[2].get<std::string>())
-                 << endl;
         }
 
     } catch (const mysqlx::Error &e) {
-        cerr << "获取任务失败: " << e.what() << endl;
+        LOG_ERROR("获取任务失败: " << e.what());
     }
     return user;
 }
 
 int Database::getIdByName(const std::string &username) {
+    DB_TIMED("getIdByName");
     if (!connected_) {
         return -1;
     }
 
     int id = -1;
     try {
-        Schema db = session_->getSchema(DATABASE);
-        Table users = db.getTable("users");
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
 
         // 查询用户信息
-        auto result = users.select("id")
-                       .where("username = :username")
+        auto result = stmt.userIdByName
                        .bind("username", username)
                        .execute();
 
         if (result.count() == 0) {
-            cout << "错误: 用户不存在!" << endl;
+            LOG_WARN("错误: 用户不存在!");
             id =-1;
         } else {
             Row row = result.fetchOne();
@@ -380,7 +511,119 @@ int Database::getIdByName(const std::string &username) {
             id = row[0].get<int>();
         }
     } catch (const mysqlx::Error &e) {
-        cerr << "登录失败: " << e.what() << endl;
+        LOG_ERROR("登录失败: " << e.what());
     }
     return id;
 }
+
+// 整批操作在一个事务里完成，往返次数和批大小无关：
+// 锁定涉及的任务 -> 多行 INSERT -> 按最终状态各一条 UPDATE ... IN -> 一条 DELETE ... IN
+// -> 读回新建和修改过的任务 -> 提交
+bool Database::applyTaskBatch(int userId, const std::vector<TaskOp> &ops, std::vector<TaskOpResult> &results) {
+    DB_TIMED("applyTaskBatch");
+    results.clear();
+    if (!connected_ || ops.empty()) {
+        return false;
+    }
+
+    std::vector<int> targets;
+    for (const TaskOp &op : ops) {
+        if (op.type != TaskOp::Create) {
+            targets.push_back(op.taskId);
+        }
+    }
+
+    try {
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
+        session->startTransaction();
+        try {
+            // 锁住要修改的行，检查存在性和执行之间不会被其它请求删掉
+            std::unordered_set<int> existing;
+            if (!targets.empty()) {
+                RowResult rows = stmt.tasks.select("id")
+                    .where("user_id = :user_id AND id IN (" + idList(targets) + ")")
+                    .lockExclusive()
+                    .bind("user_id", userId)
+                    .execute();
+                for (Row row : rows) {
+                    existing.insert(row[0].get<int>());
+                }
+            }
+
+            TaskBatchPlan plan;
+            if (!planTaskBatch(ops, existing, plan, results)) {
+                session->rollback();
+                return false;
+            }
+
+            std::vector<int> readBack;
+            if (!plan.creates.empty()) {
+                std::vector<int> ids = insertTaskRows(stmt, userId, plan.creates);
+                for (size_t i = 0; i < ids.size(); i++) {
+                    results[plan.createOps[i]].taskId = ids[i];
+                    readBack.push_back(ids[i]);
+                }
+            }
+            for (bool completed : {true, false}) {
+                const std::vector<int> &ids = completed ? plan.markCompleted : plan.markPending;
+                if (ids.empty()) {
+                    continue;
+                }
+                stmt.tasks.update()
+                    .set("completed", completed)
+                    .where("user_id = :user_id AND id IN (" + idList(ids) + ")")
+                    .bind("user_id", userId)
+                    .execute();
+                readBack.insert(readBack.end(), ids.begin(), ids.end());
+            }
+            if (!plan.deletes.empty()) {
+                stmt.tasks.remove()
+                    .where("user_id = :user_id AND id IN (" + idList(plan.deletes) + ")")
+                    .bind("user_id", userId)
+                    .execute();
+            }
+
+            // 新建任务的 created_at 由数据库生成，和修改后的任务一起读回
+            std::unordered_map<int, Task> changed;
+            if (!readBack.empty()) {
+                RowResult rows = stmt.tasks.select("id", "title", "description", "completed",
+                                                   "CAST(due_date AS CHAR)", "CAST(created_at AS CHAR)")
+                    .where("user_id = :user_id AND id IN (" + idList(readBack) + ")")
+                    .bind("user_id", userId)
+                    .execute();
+                for (Row row : rows) {
+                    Task task = rowToTask(row);
+                    changed[task.id] = task;
+                }
+            }
+            session->commit();
+
+            for (TaskOpResult &result : results) {
+                auto it = changed.find(result.taskId);
+                if (it != changed.end()) {
+                    result.task = it->second;
+                }
+            }
+        } catch (...) {
+            // 任何异常（不只是 mysqlx::Error，也包括 bad_alloc 等）都先回滚，
+            // 不能把还开着事务的连接还回池里；回滚失败说明连接已不可用，直接销毁
+            try {
+                session->rollback();
+            } catch (...) {
+                session.invalidate();
+            }
+            throw;
+        }
+
+        TaskCache::getInstance().invalidate(userId);
+        LOG_DEBUG("用户 " << userId << " 批量修改任务 " << ops.size() << " 条");
+        return true;
+    } catch (const mysqlx::Error &e) {
+        LOG_ERROR("批量修改任务失败: " << e.what());
+    } catch (const std::exception &e) {
+        LOG_ERROR("批量修改任务失败: " << e.what());
+    }
+    results.clear();
+    return false;
+}
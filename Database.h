@@ -1,12 +1,15 @@
+#ifndef DATABASE_H
+#define DATABASE_H
+
 #include <iostream>
 #include <string> // 明确包含 std::string
+#include <functional>
 #include <mysqlx/xdevapi.h>
 #include "PasswordHasher.h"
+#include "Storage.h"
 
 // 使用命名空间，但避免 using namespace std; 以免冲突
 using mysqlx::Session;
-using mysqlx::SessionSettings;
-using mysqlx::SessionOption;
 using mysqlx::Schema;
 using mysqlx::Table;
 using mysqlx::Row;
@@ -18,53 +21,31 @@ using std::cerr;
 using std::endl;
 using std::cin;
 
-class Task {
-public:
-    Task() : id(0), completed(false) {}
-    ~Task() {}
-
-//private:
-    int id;
-    std::string title;
-    std::string text;
-    bool completed;
-    std::string datetime;
-    std::string timestamp;
-};
-
-class User {
-public:
-    User() : id(-1) {}
-    ~User() {}
-
-//private:
-    int id;
-    std::string username;
-    std::string email;
-    std::string timestamp;
-    std::string password_hash;
-    std::vector<Task> task;
-};
-
-class Database {
+// MySQL（X DevAPI）存储后端
+class Database : public Storage {
 public:
     Database();
     ~Database();
-    bool connect();
-    void disconnect();
-    bool registerUser(const std::string &username, const std::string &email, const std::string &password);
-    bool loginUser(const std::string &username, const std::string &password);
-    bool addTask(int id, const Task &t);
-    bool delTask(int taskId);
-    bool updateTaskStatus(int taskId, bool completed);
-    std::vector<Task> getUserTasks(int id);
-    User getUser(const std::string &username);
-    User getUser(int id);
-    int getIdByName(const std::string &username);
+    bool connect() override;
+    void disconnect() override;
+    bool registerUser(const std::string &username, const std::string &email, const std::string &password) override;
+    bool loginUser(const std::string &username, const std::string &password, User &user) override;
+    int addTask(int id, const Task &t) override;
+    std::vector<int> addTasks(int id, const std::vector<Task> &tasks) override;
+    bool delTask(int userId, int taskId) override;
+    bool updateTaskStatus(int userId, int taskId, bool completed) override;
+    bool getTask(int userId, int taskId, Task &task) override;
+    std::vector<Task> getUserTasks(int id) override;
+    PageResult getUserTasksPage(int id, size_t limit, const std::string &after, TaskPage &page) override;
+    bool streamUserTasks(int id, const std::function<bool(const Task&)> &onTask) override;
+    User getUser(const std::string &username) override;
+    User getUser(int id) override;
+    int getIdByName(const std::string &username) override;
+    bool applyTaskBatch(int userId, const std::vector<TaskOp> &ops, std::vector<TaskOpResult> &results) override;
 
 private:
-    std::unique_ptr<mysqlx::Session> session_; // 使用智能指针
+    // 不再独占 Session，每次操作从 ConnectionPool 借一条连接，用完归还
     bool connected_;
 };
 
-
+#endif // DATABASE_H
@@ -1,14 +1,247 @@
 #include "JwtManager.h"
-#include <iostream>
+#include "Logger.h"
+#include "Metrics.h"
+#include <charconv>
+#include <cstring>
+#include <string_view>
 #include <stdexcept>
 
+#ifdef JWT_OPENSSL_3_0
+#include <openssl/core_names.h>
+
+struct Hs256Key::State {
+    EVP_MAC *mac = nullptr;
+    EVP_MAC_CTX *ctx = nullptr;     // 已设置好密钥，只用来复制
+
+    ~State() {
+        EVP_MAC_CTX_free(ctx);
+        EVP_MAC_free(mac);
+    }
+};
+
+Hs256Key::Hs256Key(const std::string& secret) {
+    auto state = std::make_shared<State>();
+    char digest[] = "SHA256";
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+        OSSL_PARAM_construct_end()
+    };
+    state->mac = EVP_MAC_fetch(nullptr, "HMAC", nullptr);
+    if (state->mac) {
+        state->ctx = EVP_MAC_CTX_new(state->mac);
+    }
+    if (!state->ctx || !EVP_MAC_init(state->ctx, reinterpret_cast<const unsigned char*>(secret.data()),
+                                     secret.size(), params)) {
+        throw std::runtime_error("failed to initialise HMAC-SHA256 context");
+    }
+    state_ = state;
+}
+
+bool Hs256Key::mac(const char* data, size_t len, unsigned char* out) const {
+    size_t outLen = 0;
+    EVP_MAC_CTX *ctx = EVP_MAC_CTX_dup(state_->ctx);
+    bool ok = ctx && EVP_MAC_update(ctx, reinterpret_cast<const unsigned char*>(data), len) &&
+              EVP_MAC_final(ctx, out, &outLen, kMacSize) && outLen == kMacSize;
+    EVP_MAC_CTX_free(ctx);
+    return ok;
+}
+#else
+// 旧版 OpenSSL 没有可复制的 EVP_MAC 上下文，退回一次性的 HMAC()
+struct Hs256Key::State {
+    std::string secret;
+};
+
+Hs256Key::Hs256Key(const std::string& secret) {
+    auto state = std::make_shared<State>();
+    state->secret = secret;
+    state_ = state;
+}
+
+bool Hs256Key::mac(const char* data, size_t len, unsigned char* out) const {
+    unsigned int outLen = 0;
+    return HMAC(EVP_sha256(), state_->secret.data(), static_cast<int>(state_->secret.size()),
+                reinterpret_cast<const unsigned char*>(data), len, out, &outLen) != nullptr &&
+           outLen == kMacSize;
+}
+#endif
+
+std::string Hs256Key::sign(const std::string& data, std::error_code& ec) const {
+    ec.clear();
+    std::string res(kMacSize, '\0');
+    if (!mac(data.data(), data.size(), reinterpret_cast<unsigned char*>(&res[0]))) {
+        ec = jwt::error::signature_generation_error::hmac_failed;
+        return {};
+    }
+    return res;
+}
+
+void Hs256Key::verify(const std::string& data, const std::string& signature, std::error_code& ec) const {
+    std::string expected = sign(data, ec);
+    if (ec) {
+        return;
+    }
+    // 定长比较，不因第一个不同的字节提前返回
+    if (expected.size() != signature.size() ||
+        CRYPTO_memcmp(expected.data(), signature.data(), expected.size()) != 0) {
+        ec = jwt::error::signature_verification_error::invalid_signature;
+    }
+}
+
+namespace {
+
+// base64url 解码表，-1 表示不是合法字符
+struct Base64UrlTable {
+    signed char value[256];
+    Base64UrlTable() {
+        const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+        std::memset(value, -1, sizeof(value));
+        for (int i = 0; i < 64; i++) {
+            value[static_cast<unsigned char>(alphabet[i])] = static_cast<signed char>(i);
+        }
+    }
+};
+const Base64UrlTable kBase64Url;
+
+// 解码不带填充的 base64url，结果超过 cap 或有非法字符时返回 false
+bool decodeBase64Url(const char *in, size_t len, unsigned char *out, size_t cap, size_t &outLen) {
+    if (len % 4 == 1 || len / 4 * 3 + (len % 4 ? len % 4 - 1 : 0) > cap) {
+        return false;
+    }
+    outLen = 0;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (size_t i = 0; i < len; i++) {
+        int v = kBase64Url.value[static_cast<unsigned char>(in[i])];
+        if (v < 0) {
+            return false;
+        }
+        acc = (acc << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out[outLen++] = static_cast<unsigned char>(acc >> bits);
+        }
+    }
+    // 末尾多出的位必须为 0，否则同一个 payload 会有多种写法
+    return (acc & ((1u << bits) - 1)) == 0;
+}
+
+// 拆出签名输入（最后一个 '.' 之前的部分）并严格解码签名。
+// 签名写法不规范或长度不是 32 字节时返回 false，这样的 token 不可能是我们签发的
+bool splitSignature(const std::string &token, size_t &signingInputLen, TokenCache::Signature &signature) {
+    size_t dot = token.rfind('.');
+    if (dot == std::string::npos) {
+        return false;
+    }
+    size_t len = 0;
+    if (!decodeBase64Url(token.data() + dot + 1, token.size() - dot - 1,
+                         signature.data(), signature.size(), len) || len != signature.size()) {
+        return false;
+    }
+    signingInputLen = dot;
+    return true;
+}
+
+Counter &verifyFailures() {
+    static Counter &failures = Metrics::getInstance().counter(
+        "todo_jwt_verify_failures_total", "JWT verifications that were rejected");
+    return failures;
+}
+
+// 只认识扁平的 JSON 对象：值为不含转义的字符串或整数。其它写法都让调用方走通用路径
+class PayloadScanner {
+public:
+    PayloadScanner(const char *begin, const char *end) : p_(begin), end_(end) {}
+
+    bool objectBegin() { skipSpace(); return consume('{'); }
+    // 读下一个键，读到对象结尾时 done 为 true
+    bool nextKey(std::string_view &key, bool &done) {
+        skipSpace();
+        done = consume('}');
+        if (done) {
+            skipSpace();
+            return p_ == end_;
+        }
+        if (!first_) {
+            if (!consume(',')) {
+                return false;
+            }
+            skipSpace();
+        }
+        first_ = false;
+        if (!string(key)) {
+            return false;
+        }
+        skipSpace();
+        if (!consume(':')) {
+            return false;
+        }
+        skipSpace();
+        return true;
+    }
+    bool isString() const { return p_ < end_ && *p_ == '"'; }
+    bool string(std::string_view &value) {
+        if (!consume('"')) {
+            return false;
+        }
+        const char *start = p_;
+        while (p_ < end_ && *p_ != '"') {
+            if (*p_ == '\\' || static_cast<unsigned char>(*p_) < 0x20) {
+                return false;
+            }
+            p_++;
+        }
+        if (p_ == end_) {
+            return false;
+        }
+        value = std::string_view(start, static_cast<size_t>(p_ - start));
+        p_++;
+        return true;
+    }
+    bool integer(int64_t &value) {
+        auto result = std::from_chars(p_, end_, value);
+        if (result.ec != std::errc() || result.ptr == p_) {
+            return false;
+        }
+        p_ = result.ptr;
+        // 小数和指数形式交给通用路径
+        return p_ == end_ || (*p_ != '.' && *p_ != 'e' && *p_ != 'E');
+    }
+
+private:
+    void skipSpace() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+            p_++;
+        }
+    }
+    bool consume(char c) {
+        if (p_ < end_ && *p_ == c) {
+            p_++;
+            return true;
+        }
+        return false;
+    }
+
+    const char *p_;
+    const char *end_;
+    bool first_ = true;
+};
+
+// 快速路径处理的 payload 上限，我们签发的 token 远小于这个长度
+const size_t kMaxFastPayload = 768;
+
+} // namespace
+
 JwtManager& JwtManager::getInstance() {
     static JwtManager instance;
     return instance;
 }
 
-JwtManager::JwtManager() {
-    // 初始化代码（如果需要）
+JwtManager::JwtManager()
+    : key_(secret_key_),
+      verifier_(jwt::verify().allow_algorithm(key_).with_issuer("todo-app")) {
+    std::string sample = jwt::create().set_type("JWT").sign(key_);
+    expectedHeader_ = sample.substr(0, sample.find('.'));
 }
 
 std::string JwtManager::generateToken(int userId, const std::string& username) {
@@ -20,37 +253,235 @@ std::string JwtManager::generateToken(int userId, const std::string& username) {
             .set_payload_claim("username", jwt::claim(username))
             .set_issued_at(std::chrono::system_clock::now())
             .set_expires_at(std::chrono::system_clock::now() + std::chrono::seconds(token_expiry_))
-            .sign(jwt::algorithm::hs256{secret_key_});
+            .sign(key_);
 
         return token;
     } catch (const std::exception& e) {
-        std::cerr << "Error generating token: " << e.what() << std::endl;
+        LOG_ERROR("Error generating token: " << e.what());
         return "";
     }
 }
 
+int64_t JwtManager::now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+int JwtManager::parseUserId(const std::string& value) {
+    int id = -1;
+    auto result = std::from_chars(value.data(), value.data() + value.size(), id);
+    if (result.ec != std::errc() || result.ptr != value.data() + value.size()) {
+        return -1;
+    }
+    return id;
+}
+
 bool JwtManager::verifyToken(const std::string& token) {
+    TokenClaims claims;
+    return verifyToken(token, claims);
+}
+
+bool JwtManager::verifyToken(const std::string& token, TokenClaims& claims) {
+    static Histogram &latency = Metrics::getInstance().histogram(
+        "todo_jwt_verify_duration_seconds", "JWT decode and signature verification latency");
+    ScopedTimer timer(latency);
+
+    // 缓存和注销表按签名输入索引，签名本身要先确认是规范写法
+    size_t signingInputLen = 0;
+    TokenCache::Signature signature;
+    if (!splitSignature(token, signingInputLen, signature)) {
+        verifyFailures().inc();
+        LOG_EVERY_N(LogLevel::Warn, 100, "Token verification failed: malformed signature");
+        return false;
+    }
+    TokenCache &cache = TokenCache::getInstance();
+    TokenCache::Digest key = TokenCache::digest(token.data(), signingInputLen);
+    int64_t current = now();
+    switch (cache.lookup(key, signature, current, claims)) {
+    case TokenCache::Result::Hit:
+        return true;
+    case TokenCache::Result::Revoked:
+        LOG_EVERY_N(LogLevel::Warn, 100, "Rejected revoked token");
+        return false;
+    default:
+        break;
+    }
+    if (!verifyAndDecode(token, current, claims)) {
+        return false;
+    }
+    cache.insert(key, signature, claims, current);
+    return true;
+}
+
+JwtManager::FastResult JwtManager::fastVerify(const std::string& token, int64_t now, TokenClaims& claims,
+                                              const char*& reason) const {
+    size_t headerEnd = token.find('.');
+    if (headerEnd != expectedHeader_.size() || token.compare(0, headerEnd, expectedHeader_) != 0) {
+        return FastResult::Fallback;
+    }
+    size_t payloadEnd = token.find('.', headerEnd + 1);
+    if (payloadEnd == std::string::npos) {
+        return FastResult::Fallback;
+    }
+
+    // 签名先严格解码再比较：同一签名的非规范写法直接拒绝，不能交给宽松解码的 jwt-cpp
+    unsigned char signature[Hs256Key::kMacSize];
+    size_t signatureLen = 0;
+    if (!decodeBase64Url(token.data() + payloadEnd + 1, token.size() - payloadEnd - 1,
+                         signature, sizeof(signature), signatureLen) || signatureLen != sizeof(signature)) {
+        reason = "malformed signature";
+        return FastResult::Invalid;
+    }
+    unsigned char expected[Hs256Key::kMacSize];
+    if (!key_.mac(token.data(), payloadEnd, expected)) {
+        return FastResult::Fallback;
+    }
+    if (CRYPTO_memcmp(expected, signature, sizeof(expected)) != 0) {
+        reason = "invalid signature";
+        return FastResult::Invalid;
+    }
+
+    char payload[kMaxFastPayload];
+    size_t payloadLen = 0;
+    if (!decodeBase64Url(token.data() + headerEnd + 1, payloadEnd - headerEnd - 1,
+                         reinterpret_cast<unsigned char*>(payload), sizeof(payload), payloadLen)) {
+        return FastResult::Fallback;
+    }
+
+    // 我们签发的 token 只有这几个声明，出现别的键或重复的键都走通用路径
+    enum { kIss = 1, kTyp = 2, kUserId = 4, kUsername = 8, kIat = 16, kExp = 32 };
+    int seen = 0;
+    std::string_view issuer, userId, username;
+    int64_t issuedAt = 0, expiresAt = 0;
+    PayloadScanner scanner(payload, payload + payloadLen);
+    if (!scanner.objectBegin()) {
+        return FastResult::Fallback;
+    }
+    for (;;) {
+        std::string_view name;
+        bool done = false;
+        if (!scanner.nextKey(name, done)) {
+            return FastResult::Fallback;
+        }
+        if (done) {
+            break;
+        }
+        int bit = name == "iss" ? kIss : name == "typ" ? kTyp : name == "user_id" ? kUserId :
+                  name == "username" ? kUsername : name == "iat" ? kIat : name == "exp" ? kExp : 0;
+        if (bit == 0 || (seen & bit)) {
+            return FastResult::Fallback;
+        }
+        seen |= bit;
+        std::string_view text;
+        bool ok = false;
+        switch (bit) {
+        case kIss:      ok = scanner.string(issuer); break;
+        case kTyp:      ok = scanner.string(text); break;
+        case kUserId:   ok = scanner.string(userId); break;
+        case kUsername: ok = scanner.string(username); break;
+        case kIat:      ok = scanner.integer(issuedAt); break;
+        case kExp:      ok = scanner.integer(expiresAt); break;
+        }
+        if (!ok) {
+            return FastResult::Fallback;
+        }
+    }
+    const int required = kIss | kUserId | kUsername | kExp;
+    if ((seen & required) != required) {
+        return FastResult::Fallback;
+    }
+
+    // 与 jwt-cpp 的检查保持一致（leeway 为 0）
+    if (issuer != "todo-app") {
+        reason = "token doesn't contain the required issuer";
+        return FastResult::Invalid;
+    }
+    if (now > expiresAt) {
+        reason = "token expired";
+        return FastResult::Invalid;
+    }
+    if ((seen & kIat) && now < issuedAt) {
+        reason = "token issued in the future";
+        return FastResult::Invalid;
+    }
+
+    int id = -1;
+    auto parsed = std::from_chars(userId.data(), userId.data() + userId.size(), id);
+    if (parsed.ec != std::errc() || parsed.ptr != userId.data() + userId.size() || id <= 0) {
+        reason = "invalid user_id claim";
+        return FastResult::Invalid;
+    }
+    claims.userId = id;
+    claims.username.assign(username.data(), username.size());
+    claims.expiresAt = expiresAt;
+    return FastResult::Valid;
+}
+
+bool JwtManager::verifyAndDecode(const std::string& token, int64_t now, TokenClaims& claims) {
+    Counter &failures = verifyFailures();
+    static Counter &fallbacks = Metrics::getInstance().counter(
+        "todo_jwt_fast_path_fallbacks_total", "Tokens the fast-path verifier handed to jwt-cpp");
+
+    const char *reason = nullptr;
+    switch (fastVerify(token, now, claims, reason)) {
+    case FastResult::Valid:
+        return true;
+    case FastResult::Invalid:
+        failures.inc();
+        LOG_EVERY_N(LogLevel::Warn, 100, "Token verification failed: " << reason);
+        return false;
+    default:
+        fallbacks.inc();
+        break;
+    }
+
     try {
         auto decoded = jwt::decode(token);
-        auto verifier = jwt::verify()
-            .allow_algorithm(jwt::algorithm::hs256{secret_key_})
-            .with_issuer("todo-app");
-
-        verifier.verify(decoded);
+        verifier_.verify(decoded);
+        claims.userId = parseUserId(decoded.get_payload_claim("user_id").as_string());
+        if (claims.userId <= 0) {
+            throw std::runtime_error("invalid user_id claim");
+        }
+        claims.username = decoded.get_payload_claim("username").as_string();
+        claims.expiresAt = std::chrono::duration_cast<std::chrono::seconds>(
+            decoded.get_expires_at().time_since_epoch()).count();
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "Token verification failed: " << e.what() << std::endl;
+        failures.inc();
+        // 过期或伪造的 token 可能被客户端反复提交，按采样记录
+        LOG_EVERY_N(LogLevel::Warn, 100, "Token verification failed: " << e.what());
         return false;
     }
 }
 
+void JwtManager::revokeToken(const std::string& token, const TokenClaims& claims) {
+    size_t signingInputLen = 0;
+    TokenCache::Signature signature;
+    if (!splitSignature(token, signingInputLen, signature)) {
+        return;
+    }
+    // 按签名输入注销，同一签名的任何写法都随之失效
+    TokenCache::Digest key = TokenCache::digest(token.data(), signingInputLen);
+    TokenCache::getInstance().revoke(key, claims.expiresAt, now());
+}
+
 int JwtManager::getUserIdFromToken(const std::string& token) {
+    // token 通常刚在 pre-routing 中校验过，直接从缓存取
+    size_t signingInputLen = 0;
+    TokenCache::Signature signature;
+    if (!splitSignature(token, signingInputLen, signature)) {
+        return -1;
+    }
+    TokenClaims claims;
+    if (TokenCache::getInstance().lookup(TokenCache::digest(token.data(), signingInputLen), signature, now(),
+                                         claims) == TokenCache::Result::Hit) {
+        return claims.userId;
+    }
     try {
         auto decoded = jwt::decode(token);
-        auto claim = decoded.get_payload_claim("user_id");
-        return std::stoi(claim.as_string());
+        return parseUserId(decoded.get_payload_claim("user_id").as_string());
     } catch (const std::exception& e) {
-        std::cerr << "Error getting user ID from token: " << e.what() << std::endl;
+        LOG_ERROR("Error getting user ID from token: " << e.what());
         return -1;
     }
 }
@@ -60,7 +491,7 @@ std::string JwtManager::getUsernameFromToken(const std::string& token) {
         auto decoded = jwt::decode(token);
         return decoded.get_payload_claim("username").as_string();
     } catch (const std::exception& e) {
-        std::cerr << "Error getting username from token: " << e.what() << std::endl;
+        LOG_ERROR("Error getting username from token: " << e.what());
         return "";
     }
 }
\ No newline at end of file
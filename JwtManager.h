@@ -1,8 +1,33 @@
 #ifndef JWT_MANAGER_H
 #define JWT_MANAGER_H
 
+#include <memory>
 #include <string>
+#include <system_error>
 #include <jwt-cpp/jwt.h>  // 下载的 JWT 头文件
+#include "TokenCache.h"
+
+// 预先处理好密钥的 HS256 算法，满足 jwt-cpp 对算法类型的要求（sign/verify/name）。
+// jwt::algorithm::hs256 每次都用原始密钥做一次完整的 HMAC（OpenSSL 3 下还要重新查找 HMAC 和 SHA-256 的实现）；
+// 这里构造时就把密钥处理成 HMAC 上下文，每次签名/校验只复制一份再计算，
+// 原始上下文只读，多个工作线程可以同时使用。对象可以随意复制，复制后共享同一个上下文。
+class Hs256Key {
+public:
+    explicit Hs256Key(const std::string& secret);
+
+    static const size_t kMacSize = 32;
+
+    // 对原始字节计算 HMAC，out 至少 kMacSize 字节；不分配内存（OpenSSL 3 下除了复制上下文）
+    bool mac(const char* data, size_t len, unsigned char* out) const;
+
+    std::string sign(const std::string& data, std::error_code& ec) const;
+    void verify(const std::string& data, const std::string& signature, std::error_code& ec) const;
+    std::string name() const { return "HS256"; }
+
+private:
+    struct State;
+    std::shared_ptr<const State> state_;
+};
 
 class JwtManager {
 public:
@@ -11,8 +36,15 @@ public:
     // 生成 JWT token
     std::string generateToken(int userId, const std::string& username);
 
-    // 验证 JWT token
+    // 验证 JWT token（先查已校验 token 的缓存）
     bool verifyToken(const std::string& token);
+    // 同上，成功时填写 token 中的声明
+    bool verifyToken(const std::string& token, TokenClaims& claims);
+
+    // 注销 token：直到过期前都不再通过校验。
+    // claims 必须是 verifyToken 对同一个 token 校验得到的声明（见 AuthContext），这里不再解码 token，
+    // 未经校验的 token 不能往注销表里写入任意的摘要和过期时间
+    void revokeToken(const std::string& token, const TokenClaims& claims);
 
     // 从 token 中获取用户ID
     int getUserIdFromToken(const std::string& token);
@@ -24,8 +56,26 @@ private:
     JwtManager();
     ~JwtManager() = default;
 
+    // 完整解码并校验签名，成功时填写 claims
+    bool verifyAndDecode(const std::string& token, int64_t now, TokenClaims& claims);
+
+    // 快速路径：只处理本服务签发的 token（固定的头部、固定的几个声明），
+    // 直接对原始的 header.payload 计算 HMAC，在栈上解码 payload 并逐字符扫描取出声明，不构造 JSON 对象。
+    // 签名错误或写法不规范、已过期、签发方不对时返回 Invalid；其它格式和预期有出入时返回 Fallback，交给 jwt-cpp 处理。
+    enum class FastResult { Valid, Invalid, Fallback };
+    FastResult fastVerify(const std::string& token, int64_t now, TokenClaims& claims, const char*& reason) const;
+    static int64_t now();
+    // user_id 声明是十进制字符串，格式不对时返回 -1
+    static int parseUserId(const std::string& value);
+
     const std::string secret_key_ = "your-super-secret-key-change-in-production";
     const int token_expiry_ = 3600; // 1小时过期
+
+    // 构造时建好，之后只读：verifier::verify 是 const 的，各工作线程共用
+    const Hs256Key key_;
+    const jwt::verifier<jwt::default_clock, jwt::traits::kazuho_picojson> verifier_;
+    // generateToken 签出的 token 的头部（base64url），快速路径只接受完全相同的头部
+    std::string expectedHeader_;
 };
 
 #endif // JWT_MANAGER_H
\ No newline at end of file
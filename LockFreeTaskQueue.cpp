@@ -0,0 +1,123 @@
+// LockFreeTaskQueue.cpp
+#include "LockFreeTaskQueue.h"
+#include "AdmissionController.h"
+
+namespace {
+
+// 找不到任务时先让出 CPU 重试几轮再休眠，连接密集到达时避免频繁进出内核
+const int kSpinRounds = 64;
+
+} // namespace
+
+LockFreeTaskQueue::LockFreeTaskQueue(size_t threads, size_t queueCapacity)
+    : queue_(queueCapacity), queued_(0), sleepers_(0), stopping_(false),
+      depth_(Metrics::getInstance().gauge(
+          "todo_http_queue_depth", "Connections waiting for a worker thread")),
+      busy_(Metrics::getInstance().gauge(
+          "todo_http_busy_workers", "Worker threads currently serving a connection")),
+      rejected_(Metrics::getInstance().counter(
+          "todo_http_queue_rejected_total", "Connections rejected because the queue was full")),
+      wait_(Metrics::getInstance().histogram(
+          "todo_http_queue_wait_seconds", "Time a connection waited for a worker thread")) {
+    if (threads == 0) {
+        threads = 1;
+    }
+    Metrics::getInstance().gauge("todo_http_worker_threads", "Size of the HTTP worker pool")
+        .set(static_cast<int64_t>(threads));
+
+    for (size_t i = 0; i < threads; i++) {
+        threads_.emplace_back(&LockFreeTaskQueue::workerLoop, this);
+    }
+}
+
+LockFreeTaskQueue::~LockFreeTaskQueue() {
+    shutdown();
+}
+
+bool LockFreeTaskQueue::enqueue(std::function<void()> fn) {
+    if (stopping_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    Job job;
+    job.fn = std::move(fn);
+    job.enqueued = std::chrono::steady_clock::now();
+
+    // 先计数再放入，消费者取到任务时计数一定已经加上
+    queued_.fetch_add(1, std::memory_order_seq_cst);
+    if (!queue_.tryPush(job)) {
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        rejected_.inc();
+        return false;
+    }
+    depth_.add();
+    unparkOne();
+    return true;
+}
+
+// 与 workerLoop 中的休眠配对：这里先增加 queued_ 再读 sleepers_，休眠方先增加 sleepers_ 再读 queued_，
+// 两边都是顺序一致的原子操作，至少有一方能看到另一方的修改，所以不会出现任务在队列里而所有线程都在睡的情况
+void LockFreeTaskQueue::unparkOne() {
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        parkCond_.notify_one();
+    }
+}
+
+void LockFreeTaskQueue::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        if (stopping_.exchange(true)) {
+            return;
+        }
+    }
+    parkCond_.notify_all();
+    // 已入队的任务执行完后工作线程才退出，与 httplib::ThreadPool 一致
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+void LockFreeTaskQueue::workerLoop() {
+    Job job;
+    for (;;) {
+        bool found = findJob(job);
+        for (int i = 0; !found && i < kSpinRounds && queued_.load(std::memory_order_relaxed) > 0; i++) {
+            std::this_thread::yield();
+            found = findJob(job);
+        }
+        if (found) {
+            run(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(parkMutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        while (!stopping_.load(std::memory_order_relaxed) && queued_.load(std::memory_order_seq_cst) == 0) {
+            parkCond_.wait(lock);
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        if (stopping_.load(std::memory_order_relaxed) && queued_.load(std::memory_order_seq_cst) == 0) {
+            break;
+        }
+    }
+}
+
+bool LockFreeTaskQueue::findJob(Job &job) {
+    if (!queue_.tryPop(job)) {
+        return false;
+    }
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    depth_.sub();
+    return true;
+}
+
+void LockFreeTaskQueue::run(Job &job) {
+    wait_.observe(std::chrono::steady_clock::now() - job.enqueued);
+    AdmissionController::noteQueued(job.enqueued);
+    {
+        ScopedGauge busy(busy_);
+        job.fn();
+    }
+    // 尽快释放任务捕获的对象
+    job.fn = nullptr;
+}
@@ -0,0 +1,144 @@
+// LockFreeTaskQueue.h
+#ifndef LOCK_FREE_TASK_QUEUE_H
+#define LOCK_FREE_TASK_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "httplib.h"
+#include "Metrics.h"
+
+// 有界多生产者多消费者无锁队列（Dmitry Vyukov 的环形数组算法）。
+// 每个槽位带一个序号，生产者和消费者各自用一次 CAS 抢位置，不需要锁，也不为每个元素分配内存。
+template <class T>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(size_t capacity) : enqueuePos_(0), dequeuePos_(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    // 队列满时返回 false，value 保持不变
+    bool tryPush(T &value) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T &value) {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->value);
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 并发修改时只是近似值
+    size_t sizeApprox() const {
+        size_t head = dequeuePos_.load(std::memory_order_relaxed);
+        size_t tail = enqueuePos_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueuePos_;
+    alignas(64) std::atomic<size_t> dequeuePos_;
+};
+
+// 替换 httplib 默认 ThreadPool（一把锁 + 一个条件变量 + std::list，每个任务分配一个链表节点）的执行器：
+// - 提交方（accept 线程、keep-alive 反应器线程）把任务放进无锁的有界队列，不分配链表节点；
+// - 空闲的工作线程从队列取任务，取不到时短暂自旋后休眠；
+// - 提交任务时只有存在休眠线程才进入互斥锁唤醒一个，线程都在忙时提交路径上没有锁。
+// 同时记录排队深度、排队时间和忙碌线程数，与 InstrumentedTaskQueue 的指标名一致。
+// 对比 httplib::ThreadPool 的基准见 bench/executor_bench.cpp。
+class LockFreeTaskQueue : public httplib::TaskQueue {
+public:
+    // queueCapacity 为队列容量（向上取 2 的幂），满时拒绝新连接
+    LockFreeTaskQueue(size_t threads, size_t queueCapacity);
+    ~LockFreeTaskQueue() override;
+
+    bool enqueue(std::function<void()> fn) override;
+    void shutdown() override;
+
+private:
+    struct Job {
+        std::function<void()> fn;
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    void workerLoop();
+    bool findJob(Job &job);
+    void run(Job &job);
+    void unparkOne();
+
+    MpmcQueue<Job> queue_;
+    std::vector<std::thread> threads_;
+
+    // 队列中的任务数，休眠前检查它，避免漏掉唤醒
+    std::atomic<size_t> queued_;
+    std::atomic<int> sleepers_;
+    std::atomic<bool> stopping_;
+    std::mutex parkMutex_;          // 只在休眠和唤醒时使用
+    std::condition_variable parkCond_;
+
+    Gauge &depth_;
+    Gauge &busy_;
+    Counter &rejected_;
+    Histogram &wait_;
+};
+
+#endif // LOCK_FREE_TASK_QUEUE_H
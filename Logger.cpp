@@ -0,0 +1,255 @@
+// Logger.cpp
+#include "Logger.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+const char *levelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug: return "DEBUG";
+    case LogLevel::Info:  return "INFO ";
+    case LogLevel::Warn:  return "WARN ";
+    case LogLevel::Error: return "ERROR";
+    default:              return "     ";
+    }
+}
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+std::streamsize Logger::FixedBuffer::xsputn(const char *s, std::streamsize n) {
+    std::streamsize room = epptr() - pptr();
+    std::streamsize copy = n;
+    if (copy > room) {
+        overflowed_ = true;
+        copy = room;
+    }
+    std::memcpy(pptr(), s, static_cast<size_t>(copy));
+    pbump(static_cast<int>(copy));
+    // 总是报告全部写入，避免流进入错误状态
+    return n;
+}
+
+// 线程退出时只标记缓冲区关闭，剩余日志由后台线程写完后回收
+struct Logger::ThreadState {
+    explicit ThreadState(Logger &logger) : ring(std::make_shared<Ring>()), stream(&buffer) {
+        std::lock_guard<std::mutex> lock(logger.ringsMutex_);
+        ring->thread = logger.nextThread_++;
+        logger.rings_.push_back(ring);
+    }
+    ~ThreadState() {
+        ring->closed.store(true, std::memory_order_release);
+    }
+
+    std::shared_ptr<Ring> ring;
+    FixedBuffer buffer;
+    std::ostream stream;
+};
+
+Logger& Logger::getInstance() {
+    static Logger instance;
+    return instance;
+}
+
+Logger::Logger()
+    : level_(static_cast<int>(LogLevel::Info)), running_(false), nextThread_(0),
+      stopping_(false), written_(0), dropped_(0), truncated_(0) {
+}
+
+Logger::~Logger() {
+    shutdown();
+}
+
+bool Logger::parseLevel(const std::string &name, LogLevel &level) {
+    static const struct { const char *name; LogLevel level; } names[] = {
+        {"debug", LogLevel::Debug}, {"info", LogLevel::Info}, {"warn", LogLevel::Warn},
+        {"error", LogLevel::Error}, {"off", LogLevel::Off},
+    };
+    for (const auto &item : names) {
+        if (name == item.name) {
+            level = item.level;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Logger::start() {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    if (writer_.joinable()) {
+        return;
+    }
+    stopping_ = false;
+    writer_ = std::thread(&Logger::writerLoop, this);
+    running_.store(true, std::memory_order_release);
+}
+
+void Logger::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        if (!writer_.joinable()) {
+            return;
+        }
+        stopping_ = true;
+    }
+    writerWake_.notify_all();
+    writer_.join();
+    // 之后的日志同步写出。请求线程可能在这之前看到 running_ 为 true、正往缓冲区里写，
+    // 等这些写入完成再做最后一次取出，否则它们会留在缓冲区里既没写出也没计入丢弃数
+    running_.store(false);
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        for (const std::shared_ptr<Ring> &ring : rings_) {
+            while (ring->pushing.load()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    std::string out, err;
+    drainOnce(out, err);
+    flush(out, err);
+}
+
+Logger::ThreadState &Logger::threadState() {
+    thread_local ThreadState state(*this);
+    return state;
+}
+
+std::ostream &Logger::beginRecord() {
+    ThreadState &state = threadState();
+    state.buffer.reset();
+    state.stream.clear();
+    return state.stream;
+}
+
+void Logger::commitRecord(LogLevel level) {
+    ThreadState &state = threadState();
+    if (state.buffer.overflowed()) {
+        truncated_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 先标记正在写入再检查 running_，与 shutdown 的顺序相反（都是 seq_cst）：
+    // shutdown 要么看到 pushing 并等这条写完，要么这里看到 running_ 已清除而改为同步写出
+    Ring &ring = *state.ring;
+    ring.pushing.store(true);
+    if (!running_.load()) {
+        ring.pushing.store(false, std::memory_order_release);
+        Record record;
+        record.timeNs = nowNs();
+        record.thread = ring.thread;
+        record.level = static_cast<uint8_t>(level);
+        record.length = static_cast<uint16_t>(state.buffer.size());
+        std::memcpy(record.text, state.buffer.data(), record.length);
+        std::string out, err;
+        std::lock_guard<std::mutex> lock(syncMutex_);
+        writeRecord(record, out, err);
+        flush(out, err);
+        return;
+    }
+
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= kRingSlots) {
+        ring.pushing.store(false, std::memory_order_release);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Record &record = ring.slots[head % kRingSlots];
+    record.timeNs = nowNs();
+    record.thread = ring.thread;
+    record.level = static_cast<uint8_t>(level);
+    record.length = static_cast<uint16_t>(state.buffer.size());
+    std::memcpy(record.text, state.buffer.data(), record.length);
+    ring.head.store(head + 1, std::memory_order_release);
+    ring.pushing.store(false, std::memory_order_release);
+}
+
+// 时间戳在后台线程格式化，请求线程只记录时钟值
+void Logger::writeRecord(const Record &record, std::string &out, std::string &err) {
+    time_t seconds = static_cast<time_t>(record.timeNs / 1000000000);
+    int millis = static_cast<int>(record.timeNs / 1000000 % 1000);
+    struct tm tm;
+    localtime_r(&seconds, &tm);
+    char prefix[64];
+    int n = std::snprintf(prefix, sizeof(prefix), "%04d-%02d-%02d %02d:%02d:%02d.%03d %s [%u] ",
+                          tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                          tm.tm_hour, tm.tm_min, tm.tm_sec, millis,
+                          levelName(static_cast<LogLevel>(record.level)), record.thread);
+
+    std::string &target = record.level >= static_cast<uint8_t>(LogLevel::Warn) ? err : out;
+    target.append(prefix, n > 0 ? static_cast<size_t>(n) : 0);
+    target.append(record.text, record.length);
+    target += '\n';
+    written_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::flush(std::string &out, std::string &err) {
+    if (!out.empty()) {
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        std::fflush(stdout);
+        out.clear();
+    }
+    if (!err.empty()) {
+        std::fwrite(err.data(), 1, err.size(), stderr);
+        std::fflush(stderr);
+        err.clear();
+    }
+}
+
+size_t Logger::drainOnce(std::string &out, std::string &err) {
+    size_t count = 0;
+    std::vector<std::shared_ptr<Ring>> finished;   // 在锁外释放
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    for (size_t i = 0; i < rings_.size();) {
+        Ring &ring = *rings_[i];
+        // 先读 closed 再读 head：看到关闭时，线程退出前写入的日志一定可见
+        bool closed = ring.closed.load(std::memory_order_acquire);
+        uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+        uint64_t head = ring.head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            writeRecord(ring.slots[tail % kRingSlots], out, err);
+            count++;
+        }
+        ring.tail.store(tail, std::memory_order_release);
+        if (closed) {
+            finished.push_back(std::move(rings_[i]));
+            rings_[i] = std::move(rings_.back());
+            rings_.pop_back();
+            continue;
+        }
+        i++;
+    }
+    return count;
+}
+
+// 有日志时持续写出，空闲时短暂休眠；请求线程不通知，避免在热路径上进入内核
+void Logger::writerLoop() {
+    std::string out, err;
+    out.reserve(64 * 1024);
+    std::unique_lock<std::mutex> lock(writerMutex_);
+    while (!stopping_) {
+        lock.unlock();
+        size_t count = drainOnce(out, err);
+        flush(out, err);
+        lock.lock();
+        if (count == 0) {
+            writerWake_.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+    lock.unlock();
+    drainOnce(out, err);
+    flush(out, err);
+}
+
+LoggerStats Logger::stats() const {
+    LoggerStats s;
+    s.written = written_;
+    s.dropped = dropped_;
+    s.truncated = truncated_;
+    return s;
+}
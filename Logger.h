@@ -0,0 +1,154 @@
+// Logger.h
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+enum class LogLevel : int {
+    Debug = 0,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+// 日志运行指标快照
+struct LoggerStats {
+    uint64_t written = 0;     // 已写出的条数
+    uint64_t dropped = 0;     // 缓冲区满被丢弃的条数
+    uint64_t truncated = 0;   // 超长被截断的条数
+};
+
+// 异步日志。请求线程把日志格式化进本线程的环形缓冲区（单生产者单消费者，无锁），
+// 后台线程批量取出写到 stdout/stderr（Warn 及以上写 stderr）。
+// 写日志永远不会阻塞请求线程：缓冲区满时直接丢弃并计数。
+// 用法：LOG_INFO("Request: " << req.method << " " << req.path);
+class Logger {
+public:
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    static Logger& getInstance();
+
+    // 启动后台写线程；未调用前日志直接同步写出（启动阶段和命令行工具用）
+    void start();
+    // 写出所有缓冲的日志并停止后台线程；与之并发写入的日志改为同步写出，不会丢失
+    void shutdown();
+
+    void setLevel(LogLevel level) { level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel level() const { return static_cast<LogLevel>(level_.load(std::memory_order_relaxed)); }
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    // 解析 "debug" / "info" / "warn" / "error" / "off"，无法识别时返回 false
+    static bool parseLevel(const std::string &name, LogLevel &level);
+
+    // 本线程的格式化流，写入固定大小的缓冲区，不分配内存；由 LOG_* 宏使用
+    std::ostream &beginRecord();
+    void commitRecord(LogLevel level);
+
+    LoggerStats stats() const;
+
+private:
+    Logger();
+    ~Logger();
+
+    // 单条日志，固定大小，放在环形缓冲区的槽位中
+    static const size_t kRecordSize = 256;
+    struct Record {
+        int64_t timeNs;        // system_clock 纳秒
+        uint32_t thread;       // 线程编号（注册顺序）
+        uint16_t length;
+        uint8_t level;
+        char text[kRecordSize - 15];
+    };
+
+    // 每个线程一个：生产者是所属线程，消费者是后台写线程
+    static const size_t kRingSlots = 512;
+    struct Ring {
+        Record slots[kRingSlots];
+        alignas(64) std::atomic<uint64_t> head{0};   // 生产者写
+        alignas(64) std::atomic<uint64_t> tail{0};   // 消费者写
+        std::atomic<bool> closed{false};             // 所属线程已退出
+        std::atomic<bool> pushing{false};            // 所属线程正在写入一条日志（shutdown 等它写完）
+        uint32_t thread = 0;
+    };
+
+    // 格式化用的定长 streambuf，写满后丢弃多余内容
+    class FixedBuffer : public std::streambuf {
+    public:
+        FixedBuffer() { reset(); }
+        void reset() { setp(data_, data_ + sizeof(data_)); overflowed_ = false; }
+        const char *data() const { return pbase(); }
+        size_t size() const { return static_cast<size_t>(pptr() - pbase()); }
+        bool overflowed() const { return overflowed_; }
+    protected:
+        int_type overflow(int_type ch) override { overflowed_ = true; return traits_type::not_eof(ch); }
+        std::streamsize xsputn(const char *s, std::streamsize n) override;
+    private:
+        char data_[sizeof(Record::text)];
+        bool overflowed_;
+    };
+
+    struct ThreadState;
+    ThreadState &threadState();
+
+    void writeRecord(const Record &record, std::string &out, std::string &err);
+    void flush(std::string &out, std::string &err);
+    size_t drainOnce(std::string &out, std::string &err);
+    void writerLoop();
+
+    std::atomic<int> level_;
+    std::atomic<bool> running_;
+
+    std::mutex ringsMutex_;                       // 只在线程注册和后台线程回收时使用
+    std::vector<std::shared_ptr<Ring>> rings_;
+    uint32_t nextThread_;
+
+    std::mutex writerMutex_;
+    std::condition_variable writerWake_;
+    bool stopping_;
+    std::thread writer_;
+
+    std::mutex syncMutex_;                        // 后台线程未启动时同步写出
+
+    std::atomic<uint64_t> written_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> truncated_;
+};
+
+#define LOG_AT(lvl, msg) \
+    do { \
+        if (Logger::getInstance().enabled(lvl)) { \
+            Logger::getInstance().beginRecord() << msg; \
+            Logger::getInstance().commitRecord(lvl); \
+        } \
+    } while (0)
+
+// 每 n 次调用只记录一次，用于高频路径（计数按调用点独立）
+#define LOG_EVERY_N(lvl, n, msg) \
+    do { \
+        static std::atomic<uint64_t> log_every_n_counter_{0}; \
+        if (Logger::getInstance().enabled(lvl) && \
+            log_every_n_counter_.fetch_add(1, std::memory_order_relaxed) % (n) == 0) { \
+            LOG_AT(lvl, msg); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(msg) LOG_AT(LogLevel::Debug, msg)
+#define LOG_INFO(msg)  LOG_AT(LogLevel::Info, msg)
+#define LOG_WARN(msg)  LOG_AT(LogLevel::Warn, msg)
+#define LOG_ERROR(msg) LOG_AT(LogLevel::Error, msg)
+
+#endif // LOGGER_H
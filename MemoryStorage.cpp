@@ -0,0 +1,279 @@
+// MemoryStorage.cpp
+#include "MemoryStorage.h"
+#include "Logger.h"
+#include "PasswordHasher.h"
+#include <ctime>
+#include <algorithm>
+
+// 和 MySQL 中 CAST(datetime AS CHAR) 的格式保持一致
+static std::string currentTimestamp() {
+    std::time_t now = std::time(nullptr);
+    std::tm tm;
+    localtime_r(&now, &tm);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+    return buf;
+}
+
+MemoryStorage::MemoryStorage() : nextUserId_(1), nextTaskId_(1) {
+}
+
+MemoryStorage::~MemoryStorage() {
+}
+
+bool MemoryStorage::connect() {
+    return true;
+}
+
+void MemoryStorage::disconnect() {
+}
+
+bool MemoryStorage::registerUser(const std::string &username, const std::string &email, const std::string &password) {
+    PasswordHasher& hasher = PasswordHasher::getInstance();
+    if (!hasher.isPasswordStrong(password)) {
+        LOG_WARN("警告: 密码安全等级较低!");
+    }
+    // 哈希在锁外完成
+    std::string hashedPassword = hasher.hashPassword(password);
+
+    std::unique_lock<std::shared_mutex> lock(usersMutex_);
+    if (idByName_.count(username) || emails_.count(email)) {
+        LOG_WARN("错误: 用户名或邮箱已存在!");
+        return false;
+    }
+    User user;
+    user.id = nextUserId_++;
+    user.username = username;
+    user.email = email;
+    user.password_hash = hashedPassword;
+    user.timestamp = currentTimestamp();
+    idByName_[username] = user.id;
+    emails_.insert(email);
+    usersById_[user.id] = user;
+    return true;
+}
+
+bool MemoryStorage::loginUser(const std::string &username, const std::string &password, User &user) {
+    User found = getUser(username);
+    if (found.id < 0) {
+        LOG_WARN("错误: 用户不存在!");
+        return false;
+    }
+    if (!PasswordHasher::getInstance().verifyPassword(found.password_hash, password)) {
+        LOG_WARN("错误: 密码不正确!");
+        return false;
+    }
+    user = found;
+    return true;
+}
+
+int MemoryStorage::addTask(int id, const Task &t) {
+    std::vector<int> ids = addTasks(id, std::vector<Task>{t});
+    return ids.empty() ? -1 : ids[0];
+}
+
+std::vector<int> MemoryStorage::addTasks(int id, const std::vector<Task> &tasks) {
+    std::vector<int> ret;
+    if (tasks.empty()) {
+        return ret;
+    }
+    std::string now = currentTimestamp();
+    TaskStripe &stripe = stripeFor(id);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    std::vector<Task> &list = stripe.tasks[id];
+    for (const Task &t : tasks) {
+        Task task = t;
+        // 在分段锁内分配ID，保证同一用户的列表按ID有序
+        task.id = nextTaskId_++;
+        task.timestamp = now;
+        list.push_back(task);
+        ret.push_back(task.id);
+    }
+    return ret;
+}
+
+bool MemoryStorage::delTask(int userId, int taskId) {
+    TaskStripe &stripe = stripeFor(userId);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    auto it = stripe.tasks.find(userId);
+    if (it == stripe.tasks.end()) {
+        return false;
+    }
+    std::vector<Task> &list = it->second;
+    auto pos = std::lower_bound(list.begin(), list.end(), taskId,
+                                [](const Task &t, int id) { return t.id < id; });
+    if (pos == list.end() || pos->id != taskId) {
+        return false;
+    }
+    list.erase(pos);
+    return true;
+}
+
+bool MemoryStorage::updateTaskStatus(int userId, int taskId, bool completed) {
+    TaskStripe &stripe = stripeFor(userId);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    auto it = stripe.tasks.find(userId);
+    if (it == stripe.tasks.end()) {
+        return false;
+    }
+    std::vector<Task> &list = it->second;
+    auto pos = std::lower_bound(list.begin(), list.end(), taskId,
+                                [](const Task &t, int id) { return t.id < id; });
+    if (pos == list.end() || pos->id != taskId || pos->completed == completed) {
+        return false;
+    }
+    pos->completed = completed;
+    return true;
+}
+
+bool MemoryStorage::getTask(int userId, int taskId, Task &task) {
+    TaskStripe &stripe = stripeFor(userId);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    auto it = stripe.tasks.find(userId);
+    if (it == stripe.tasks.end()) {
+        return false;
+    }
+    const std::vector<Task> &list = it->second;
+    auto pos = std::lower_bound(list.begin(), list.end(), taskId,
+                                [](const Task &t, int id) { return t.id < id; });
+    if (pos == list.end() || pos->id != taskId) {
+        return false;
+    }
+    task = *pos;
+    return true;
+}
+
+// 和 MySQL 后端一样按创建时间倒序返回
+std::vector<Task> MemoryStorage::getUserTasks(int id) {
+    TaskStripe &stripe = stripeFor(id);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    auto it = stripe.tasks.find(id);
+    if (it == stripe.tasks.end()) {
+        return std::vector<Task>();
+    }
+    return std::vector<Task>(it->second.rbegin(), it->second.rend());
+}
+
+// 同一用户的任务ID和 created_at 同时递增，(created_at, id) 的顺序就是ID顺序，
+// 游标位置用二分查找定位
+PageResult MemoryStorage::getUserTasksPage(int id, size_t limit, const std::string &after, TaskPage &page) {
+    page.tasks.clear();
+    page.nextCursor.clear();
+
+    std::string createdAt;
+    int lastId = 0;
+    if (!after.empty() && !decodeTaskCursor(after, createdAt, lastId)) {
+        LOG_WARN("错误: 无效的分页游标");
+        return PageResult::InvalidCursor;
+    }
+
+    TaskStripe &stripe = stripeFor(id);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    auto it = stripe.tasks.find(id);
+    if (it == stripe.tasks.end()) {
+        return PageResult::Ok;
+    }
+    const std::vector<Task> &list = it->second;
+    auto end = list.end();
+    if (!after.empty()) {
+        end = std::lower_bound(list.begin(), list.end(), lastId,
+                               [](const Task &t, int id) { return t.id < id; });
+    }
+    size_t available = static_cast<size_t>(end - list.begin());
+    size_t count = std::min(limit, available);
+    page.tasks.assign(std::make_reverse_iterator(end),
+                      std::make_reverse_iterator(end - count));
+    if (available > count) {
+        page.nextCursor = encodeTaskCursor(page.tasks.back());
+    }
+    return PageResult::Ok;
+}
+
+// 数据本来就在内存里，先在锁内复制一份，回调（可能在写网络）在锁外执行
+bool MemoryStorage::streamUserTasks(int id, const std::function<bool(const Task&)> &onTask) {
+    std::vector<Task> tasks = getUserTasks(id);
+    for (const Task &t : tasks) {
+        if (!onTask(t)) {
+            break;
+        }
+    }
+    return true;
+}
+
+User MemoryStorage::getUser(const std::string &username) {
+    std::shared_lock<std::shared_mutex> lock(usersMutex_);
+    auto it = idByName_.find(username);
+    if (it == idByName_.end()) {
+        return User();
+    }
+    return usersById_.at(it->second);
+}
+
+User MemoryStorage::getUser(int id) {
+    std::shared_lock<std::shared_mutex> lock(usersMutex_);
+    auto it = usersById_.find(id);
+    if (it == usersById_.end()) {
+        return User();
+    }
+    return it->second;
+}
+
+int MemoryStorage::getIdByName(const std::string &username) {
+    std::shared_lock<std::shared_mutex> lock(usersMutex_);
+    auto it = idByName_.find(username);
+    return it == idByName_.end() ? -1 : it->second;
+}
+
+// 整批在分段锁内完成，对其它请求来说要么全部可见要么都不可见
+bool MemoryStorage::applyTaskBatch(int userId, const std::vector<TaskOp> &ops, std::vector<TaskOpResult> &results) {
+    results.clear();
+    if (ops.empty()) {
+        return false;
+    }
+    std::string now = currentTimestamp();
+    TaskStripe &stripe = stripeFor(userId);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    std::vector<Task> &list = stripe.tasks[userId];
+
+    std::unordered_set<int> existing;
+    for (const Task &t : list) {
+        existing.insert(t.id);
+    }
+    TaskBatchPlan plan;
+    if (!planTaskBatch(ops, existing, plan, results)) {
+        return false;
+    }
+
+    auto find = [&list](int taskId) {
+        auto pos = std::lower_bound(list.begin(), list.end(), taskId,
+                                    [](const Task &t, int id) { return t.id < id; });
+        return pos != list.end() && pos->id == taskId ? pos : list.end();
+    };
+    for (bool completed : {true, false}) {
+        for (int taskId : completed ? plan.markCompleted : plan.markPending) {
+            find(taskId)->completed = completed;
+        }
+    }
+    std::unordered_set<int> deletes(plan.deletes.begin(), plan.deletes.end());
+    list.erase(std::remove_if(list.begin(), list.end(),
+                              [&deletes](const Task &t) { return deletes.count(t.id) != 0; }),
+               list.end());
+    for (size_t i = 0; i < plan.creates.size(); i++) {
+        Task task = plan.creates[i];
+        task.id = nextTaskId_++;
+        task.timestamp = now;
+        list.push_back(task);
+        results[plan.createOps[i]].taskId = task.id;
+    }
+
+    for (size_t i = 0; i < ops.size(); i++) {
+        if (ops[i].type == TaskOp::Delete) {
+            continue;
+        }
+        auto pos = find(results[i].taskId);
+        if (pos != list.end()) {
+            results[i].task = *pos;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+// MemoryStorage.h
+#ifndef MEMORY_STORAGE_H
+#define MEMORY_STORAGE_H
+
+#include <mutex>
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include "Storage.h"
+
+// 纯内存存储后端，不需要 MySQL，用于单机压测 HTTP/JWT/JSON 层，
+// 也可以和 MySQL 后端对比，单独量出数据库层的开销。进程退出后数据丢失。
+// 用户表用一把读写锁；任务按用户ID分散到 kStripes 个分段，每段一把锁。
+class MemoryStorage : public Storage {
+public:
+    MemoryStorage();
+    ~MemoryStorage();
+
+    bool connect() override;
+    void disconnect() override;
+    bool registerUser(const std::string &username, const std::string &email, const std::string &password) override;
+    bool loginUser(const std::string &username, const std::string &password, User &user) override;
+    int addTask(int id, const Task &t) override;
+    std::vector<int> addTasks(int id, const std::vector<Task> &tasks) override;
+    bool delTask(int userId, int taskId) override;
+    bool updateTaskStatus(int userId, int taskId, bool completed) override;
+    bool getTask(int userId, int taskId, Task &task) override;
+    std::vector<Task> getUserTasks(int id) override;
+    PageResult getUserTasksPage(int id, size_t limit, const std::string &after, TaskPage &page) override;
+    bool streamUserTasks(int id, const std::function<bool(const Task&)> &onTask) override;
+    User getUser(const std::string &username) override;
+    User getUser(int id) override;
+    int getIdByName(const std::string &username) override;
+    bool applyTaskBatch(int userId, const std::vector<TaskOp> &ops, std::vector<TaskOpResult> &results) override;
+
+private:
+    static const size_t kStripes = 64;
+
+    // 每个用户的任务按ID（即创建顺序）升序存放
+    struct TaskStripe {
+        std::mutex mutex;
+        std::unordered_map<int, std::vector<Task>> tasks;
+    };
+
+    TaskStripe &stripeFor(int userId) { return stripes_[static_cast<unsigned>(userId) % kStripes]; }
+
+    std::shared_mutex usersMutex_;
+    std::unordered_map<int, User> usersById_;
+    std::unordered_map<std::string, int> idByName_;
+    std::unordered_set<std::string> emails_;
+
+    std::atomic<int> nextUserId_;
+    std::atomic<int> nextTaskId_;
+    TaskStripe stripes_[kStripes];
+};
+
+#endif // MEMORY_STORAGE_H
@@ -0,0 +1,192 @@
+// Metrics.cpp
+#include "Metrics.h"
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+Histogram::Histogram(const std::vector<double> &bounds)
+    : bounds_(bounds), counts_(new std::atomic<uint64_t>[bounds.size() + 1]), sumNs_(0) {
+    for (double b : bounds_) {
+        boundsNs_.push_back(static_cast<int64_t>(b * 1e9));
+    }
+    for (size_t i = 0; i <= bounds_.size(); i++) {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+const std::vector<double> &Histogram::defaultBounds() {
+    static const std::vector<double> bounds = {
+        0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10
+    };
+    return bounds;
+}
+
+void Histogram::observe(std::chrono::nanoseconds elapsed) {
+    int64_t ns = elapsed.count() > 0 ? elapsed.count() : 0;
+    // 桶很少，线性查找比二分更快
+    size_t i = 0;
+    while (i < boundsNs_.size() && ns > boundsNs_[i]) {
+        i++;
+    }
+    counts_[i].fetch_add(1, std::memory_order_relaxed);
+    sumNs_.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> Histogram::counts() const {
+    std::vector<uint64_t> result(bounds_.size() + 1);
+    for (size_t i = 0; i < result.size(); i++) {
+        result[i] = counts_[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+Metrics& Metrics::getInstance() {
+    static Metrics instance;
+    return instance;
+}
+
+std::string Metrics::formatLabels(const MetricLabels &labels) {
+    if (labels.empty()) {
+        return std::string();
+    }
+    std::string out = "{";
+    for (size_t i = 0; i < labels.size(); i++) {
+        if (i > 0) {
+            out += ',';
+        }
+        out += labels[i].first;
+        out += "=\"";
+        // 标签值需要转义反斜杠、双引号和换行
+        for (char c : labels[i].second) {
+            if (c == '\\' || c == '"') {
+                out += '\\';
+                out += c;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+    out += '}';
+    return out;
+}
+
+std::string Metrics::formatValue(double value) {
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    char buf[32];
+    // 整数（计数器等）原样输出，其它保留足够的有效位
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        std::snprintf(buf, sizeof(buf), "%.0f", value);
+    } else {
+        std::snprintf(buf, sizeof(buf), "%.9g", value);
+    }
+    return buf;
+}
+
+Metrics::Series &Metrics::seriesFor(const std::string &name, const std::string &help, Type type,
+                                    const MetricLabels &labels) {
+    Family &family = families_[name];
+    if (family.series.empty()) {
+        family.help = help;
+        family.type = type;
+    } else if (family.type != type) {
+        throw std::logic_error("metric " + name + " registered with different types");
+    }
+    std::string key = formatLabels(labels);
+    for (auto &series : family.series) {
+        if (series->labels == key) {
+            return *series;
+        }
+    }
+    family.series.emplace_back(new Series());
+    family.series.back()->labels = key;
+    return *family.series.back();
+}
+
+Counter &Metrics::counter(const std::string &name, const std::string &help, const MetricLabels &labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series &series = seriesFor(name, help, Type::Counter, labels);
+    if (!series.counter) {
+        series.counter.reset(new Counter());
+    }
+    return *series.counter;
+}
+
+Gauge &Metrics::gauge(const std::string &name, const std::string &help, const MetricLabels &labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series &series = seriesFor(name, help, Type::Gauge, labels);
+    if (!series.gauge) {
+        series.gauge.reset(new Gauge());
+    }
+    return *series.gauge;
+}
+
+Histogram &Metrics::histogram(const std::string &name, const std::string &help, const MetricLabels &labels,
+                              const std::vector<double> &bounds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series &series = seriesFor(name, help, Type::Histogram, labels);
+    if (!series.histogram) {
+        series.histogram.reset(new Histogram(bounds));
+    }
+    return *series.histogram;
+}
+
+void Metrics::counterCallback(const std::string &name, const std::string &help, const MetricLabels &labels,
+                              std::function<double()> fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    seriesFor(name, help, Type::Counter, labels).callback = std::move(fn);
+}
+
+void Metrics::gaugeCallback(const std::string &name, const std::string &help, const MetricLabels &labels,
+                            std::function<double()> fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    seriesFor(name, help, Type::Gauge, labels).callback = std::move(fn);
+}
+
+// 直方图的 le 标签要和已有标签合在一个 {} 里
+static std::string withLe(const std::string &labels, const std::string &le) {
+    std::string item = "le=\"" + le + "\"";
+    if (labels.empty()) {
+        return "{" + item + "}";
+    }
+    return labels.substr(0, labels.size() - 1) + "," + item + "}";
+}
+
+std::string Metrics::render() const {
+    std::string out;
+    out.reserve(16 * 1024);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &item : families_) {
+        const std::string &name = item.first;
+        const Family &family = item.second;
+        const char *type = family.type == Type::Counter ? "counter" :
+                           family.type == Type::Gauge ? "gauge" : "histogram";
+        out += "# HELP " + name + " " + family.help + "\n";
+        out += "# TYPE " + name + " " + type + "\n";
+
+        for (const auto &series : family.series) {
+            if (family.type != Type::Histogram) {
+                double value = series->callback ? series->callback() :
+                               series->counter ? static_cast<double>(series->counter->value()) :
+                               series->gauge ? static_cast<double>(series->gauge->value()) : 0.0;
+                out += name + series->labels + " " + formatValue(value) + "\n";
+                continue;
+            }
+            const Histogram &h = *series->histogram;
+            std::vector<uint64_t> counts = h.counts();
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < counts.size(); i++) {
+                cumulative += counts[i];
+                std::string le = i < h.bounds().size() ? formatValue(h.bounds()[i]) : "+Inf";
+                out += name + "_bucket" + withLe(series->labels, le) + " " + std::to_string(cumulative) + "\n";
+            }
+            out += name + "_sum" + series->labels + " " + formatValue(h.sumSeconds()) + "\n";
+            out += name + "_count" + series->labels + " " + std::to_string(cumulative) + "\n";
+        }
+    }
+    return out;
+}
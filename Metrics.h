@@ -0,0 +1,151 @@
+// Metrics.h
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 指标标签，按给定顺序输出，例如 {{"method", "GET"}, {"route", "/api/tasks"}}
+typedef std::vector<std::pair<std::string, std::string>> MetricLabels;
+
+// 单调递增计数器
+class Counter {
+public:
+    Counter() : value_(0) {}
+    void inc(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+private:
+    std::atomic<uint64_t> value_;
+};
+
+// 可增可减的瞬时值
+class Gauge {
+public:
+    Gauge() : value_(0) {}
+    void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    void sub(int64_t n = 1) { value_.fetch_sub(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+private:
+    std::atomic<int64_t> value_;
+};
+
+// 耗时分布，桶上界单位为秒。每个桶和总和各是一个原子变量，记录时不加锁。
+// 总和按纳秒累加，避免浮点原子操作。
+class Histogram {
+public:
+    explicit Histogram(const std::vector<double> &bounds);
+
+    void observe(std::chrono::nanoseconds elapsed);
+    void observeSeconds(double seconds) {
+        observe(std::chrono::nanoseconds(static_cast<int64_t>(seconds * 1e9)));
+    }
+
+    const std::vector<double> &bounds() const { return bounds_; }
+    // 各桶（非累计）计数，最后一个为 +Inf
+    std::vector<uint64_t> counts() const;
+    double sumSeconds() const { return sumNs_.load(std::memory_order_relaxed) / 1e9; }
+
+    // 默认的请求/查询耗时桶：0.5ms ~ 10s
+    static const std::vector<double> &defaultBounds();
+
+private:
+    std::vector<double> bounds_;
+    std::vector<int64_t> boundsNs_;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+    std::atomic<uint64_t> sumNs_;
+};
+
+// 作用域计时：析构时把经过的时间记入直方图
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram &histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        histogram_.observe(std::chrono::steady_clock::now() - start_);
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram &histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// 作用域内 gauge 加一，用于统计并发数
+class ScopedGauge {
+public:
+    explicit ScopedGauge(Gauge &gauge) : gauge_(gauge) { gauge_.add(); }
+    ~ScopedGauge() { gauge_.sub(); }
+
+    ScopedGauge(const ScopedGauge&) = delete;
+    ScopedGauge& operator=(const ScopedGauge&) = delete;
+
+private:
+    Gauge &gauge_;
+};
+
+// 进程内指标注册表，GET /metrics 以 Prometheus 文本格式输出。
+// 注册（加锁）只在启动或第一次使用时发生，调用方保存返回的引用，之后的记录都是无锁的原子操作。
+// 同名同标签重复注册返回同一个指标。
+// 已有统计结构（连接池、缓存等）通过回调注册，在抓取时读取，不改动它们的热路径。
+class Metrics {
+public:
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    static Metrics& getInstance();
+
+    Counter &counter(const std::string &name, const std::string &help, const MetricLabels &labels = MetricLabels());
+    Gauge &gauge(const std::string &name, const std::string &help, const MetricLabels &labels = MetricLabels());
+    Histogram &histogram(const std::string &name, const std::string &help, const MetricLabels &labels = MetricLabels(),
+                         const std::vector<double> &bounds = Histogram::defaultBounds());
+
+    // 抓取时调用 fn 取值
+    void counterCallback(const std::string &name, const std::string &help, const MetricLabels &labels,
+                         std::function<double()> fn);
+    void gaugeCallback(const std::string &name, const std::string &help, const MetricLabels &labels,
+                       std::function<double()> fn);
+
+    // Prometheus 文本格式（version 0.0.4）
+    std::string render() const;
+
+private:
+    Metrics() {}
+
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Series {
+        std::string labels;                      // 已格式化的 {k="v",...}，无标签时为空
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+        std::function<double()> callback;
+    };
+
+    struct Family {
+        std::string help;
+        Type type;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    // 调用方需持有 mutex_
+    Series &seriesFor(const std::string &name, const std::string &help, Type type, const MetricLabels &labels);
+
+    static std::string formatLabels(const MetricLabels &labels);
+    static std::string formatValue(double value);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+};
+
+#endif // METRICS_H
@@ -1,5 +1,6 @@
 // PasswordHasher.cpp
 #include "PasswordHasher.h"
+#include "Metrics.h"
 #include <sodium.h>
 #include <stdexcept>
 #include <regex>
@@ -32,9 +33,30 @@ bool PasswordHasher::initialize() {
     return true;
 }
 
+// Argon2 的耗时、并发数（含排队等锁的请求）和等锁时间，按 hash/verify 分开统计
+struct Argon2Metrics {
+    explicit Argon2Metrics(const char *op)
+        : inFlight(Metrics::getInstance().gauge(
+              "todo_argon2_in_flight", "Argon2 calls in progress, including those waiting for the lock",
+              {{"op", op}})),
+          duration(Metrics::getInstance().histogram(
+              "todo_argon2_duration_seconds", "Argon2 call latency, including lock wait", {{"op", op}})),
+          lockWait(Metrics::getInstance().histogram(
+              "todo_argon2_lock_wait_seconds", "Time spent waiting for the PasswordHasher lock", {{"op", op}})) {}
+
+    Gauge &inFlight;
+    Histogram &duration;
+    Histogram &lockWait;
+};
+
 // 哈希密码
 std::string PasswordHasher::hashPassword(const std::string& password) {
+    static Argon2Metrics metrics("hash");
+    ScopedGauge concurrent(metrics.inFlight);
+    ScopedTimer timer(metrics.duration);
+    auto waitStart = std::chrono::steady_clock::now();
     std::lock_guard<std::mutex> lock(m_mutex);
+    metrics.lockWait.observe(std::chrono::steady_clock::now() - waitStart);
 
     if (!m_initialized) {
         throw std::runtime_error("PasswordHasher not initialized");
@@ -63,7 +85,12 @@ std::string PasswordHasher::hashPassword(const std::string& password) {
 
 // 验证密码
 bool PasswordHasher::verifyPassword(const std::string& hashedPassword, const std::string& password) {
+    static Argon2Metrics metrics("verify");
+    ScopedGauge concurrent(metrics.inFlight);
+    ScopedTimer timer(metrics.duration);
+    auto waitStart = std::chrono::steady_clock::now();
     std::lock_guard<std::mutex> lock(m_mutex);
+    metrics.lockWait.observe(std::chrono::steady_clock::now() - waitStart);
 
     if (!m_initialized) {
         throw std::runtime_error("PasswordHasher not initialized");
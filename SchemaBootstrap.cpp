@@ -0,0 +1,163 @@
+// SchemaBootstrap.cpp
+#include "SchemaBootstrap.h"
+#include <iostream>
+#include <map>
+#include <algorithm>
+
+using mysqlx::Session;
+using mysqlx::SessionSettings;
+using mysqlx::SessionOption;
+using mysqlx::Row;
+using mysqlx::SqlResult;
+
+SchemaBootstrap::SchemaBootstrap(const PoolConfig &config) : config_(config) {
+}
+
+// 表结构的全部历史版本，只能追加，不能修改已发布的迁移
+const std::vector<SchemaBootstrap::Migration> &SchemaBootstrap::migrations() {
+    static const std::vector<Migration> list = {
+        {1, "create users and tasks", {
+            "CREATE TABLE IF NOT EXISTS users ("
+            "  id INT NOT NULL AUTO_INCREMENT PRIMARY KEY,"
+            "  username VARCHAR(64) NOT NULL,"
+            "  email VARCHAR(255) NOT NULL,"
+            "  password_hash VARCHAR(255) NOT NULL,"
+            "  created_at DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,"
+            "  UNIQUE KEY uk_users_username (username),"
+            "  UNIQUE KEY uk_users_email (email)"
+            ") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4",
+
+            "CREATE TABLE IF NOT EXISTS tasks ("
+            "  id INT NOT NULL AUTO_INCREMENT PRIMARY KEY,"
+            "  user_id INT NOT NULL,"
+            "  title VARCHAR(255) NOT NULL,"
+            "  description TEXT NULL,"
+            "  completed BOOLEAN NOT NULL DEFAULT FALSE,"
+            "  due_date DATETIME NULL,"
+            "  created_at DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,"
+            "  KEY idx_tasks_user_created (user_id, created_at, id),"
+            "  CONSTRAINT fk_tasks_user FOREIGN KEY (user_id) REFERENCES users (id) ON DELETE CASCADE"
+            ") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4"
+        }},
+    };
+    return list;
+}
+
+// 查询依赖的索引：
+// - 任务列表/分页按 user_id 过滤、按 (created_at, id) 倒序，
+//   (user_id, created_at, id) 让 InnoDB 直接倒序扫描索引，不需要 filesort。
+//   它不是覆盖索引：title/description（TEXT，无法整列放进索引）等列仍要按主键回表，
+//   分页查询每页回表的行数以 limit + 1 为上限，完整列表则是该用户的全部任务
+// - 登录按 username 查、注册按 username/email 查重
+const std::vector<SchemaBootstrap::IndexSpec> &SchemaBootstrap::requiredIndexes() {
+    static const std::vector<IndexSpec> list = {
+        {"users", "uk_users_username", {"username"}, true},
+        {"users", "uk_users_email", {"email"}, true},
+        {"tasks", "idx_tasks_user_created", {"user_id", "created_at", "id"}, false},
+    };
+    return list;
+}
+
+bool SchemaBootstrap::run() {
+    try {
+        // 不带 DB 参数连接，库可能还不存在
+        Session session(SessionSettings(
+            SessionOption::HOST, config_.host,
+            SessionOption::PORT, config_.port,
+            SessionOption::USER, config_.user,
+            SessionOption::PWD, config_.password
+        ));
+        session.sql("CREATE DATABASE IF NOT EXISTS `" + config_.database +
+                    "` DEFAULT CHARACTER SET utf8mb4").execute();
+        session.sql("USE `" + config_.database + "`").execute();
+
+        bool ok = migrate(session) && verifyIndexes(session);
+        session.close();
+        return ok;
+    } catch (const mysqlx::Error &e) {
+        std::cerr << "初始化表结构失败: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+int SchemaBootstrap::currentVersion(Session &session) {
+    session.sql(
+        "CREATE TABLE IF NOT EXISTS schema_version ("
+        "  version INT NOT NULL PRIMARY KEY,"
+        "  description VARCHAR(255) NOT NULL,"
+        "  applied_at DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP"
+        ") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4").execute();
+    SqlResult result = session.sql("SELECT COALESCE(MAX(version), 0) FROM schema_version").execute();
+    Row row = result.fetchOne();
+    return row[0].get<int>();
+}
+
+bool SchemaBootstrap::migrate(Session &session) {
+    int version = currentVersion(session);
+    for (const Migration &m : migrations()) {
+        if (m.version <= version) {
+            continue;
+        }
+        std::cout << "执行表结构迁移 v" << m.version << ": " << m.description << std::endl;
+        // MySQL 的 DDL 会隐式提交，迁移中途失败时下次启动从失败的版本重新执行，
+        // 所以每条语句都要写成可重复执行的形式（IF NOT EXISTS 等）
+        for (const std::string &sql : m.statements) {
+            session.sql(sql).execute();
+        }
+        session.sql("INSERT INTO schema_version (version, description) VALUES (?, ?)")
+               .bind(m.version).bind(m.description).execute();
+    }
+    return true;
+}
+
+bool SchemaBootstrap::hasIndex(Session &session, const IndexSpec &spec) {
+    SqlResult result = session.sql(
+        "SELECT INDEX_NAME, NON_UNIQUE, COLUMN_NAME FROM information_schema.STATISTICS "
+        "WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ? "
+        "ORDER BY INDEX_NAME, SEQ_IN_INDEX"
+    ).bind(config_.database).bind(spec.table).execute();
+
+    // 索引名 -> (是否唯一, 列顺序)
+    std::map<std::string, std::pair<bool, std::vector<std::string>>> indexes;
+    for (Row row : result) {
+        auto &index = indexes[row[0].get<std::string>()];
+        index.first = row[1].get<int>() == 0;
+        index.second.push_back(row[2].get<std::string>());
+    }
+
+    // 名字不重要，只要有一个索引以要求的列为最左前缀即可；唯一索引要求列完全一致
+    for (const auto &item : indexes) {
+        const std::vector<std::string> &columns = item.second.second;
+        if (columns.size() < spec.columns.size() ||
+            !std::equal(spec.columns.begin(), spec.columns.end(), columns.begin())) {
+            continue;
+        }
+        if (!spec.unique || (item.second.first && columns.size() == spec.columns.size())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SchemaBootstrap::verifyIndexes(Session &session) {
+    for (const IndexSpec &spec : requiredIndexes()) {
+        if (hasIndex(session, spec)) {
+            continue;
+        }
+        std::string columns;
+        for (const std::string &c : spec.columns) {
+            columns += (columns.empty() ? "" : ", ") + c;
+        }
+        std::cout << "缺少索引 " << spec.table << "(" << columns << ")，正在创建 " << spec.name << std::endl;
+        try {
+            session.sql("ALTER TABLE `" + spec.table + "` ADD " + (spec.unique ? "UNIQUE " : "") +
+                        "INDEX `" + spec.name + "` (" + columns + ")").execute();
+        } catch (const mysqlx::Error &e) {
+            // 常见原因：已有重复数据导致唯一索引建不起来，需要人工处理
+            std::cerr << "创建索引 " << spec.name << " 失败: " << e.what() << std::endl;
+            return false;
+        }
+    }
+    std::cout << "表结构和索引检查通过" << std::endl;
+    return true;
+}
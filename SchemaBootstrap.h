@@ -0,0 +1,46 @@
+// SchemaBootstrap.h
+#ifndef SCHEMA_BOOTSTRAP_H
+#define SCHEMA_BOOTSTRAP_H
+
+#include <string>
+#include <vector>
+#include <mysqlx/xdevapi.h>
+#include "ConnectionPool.h"
+
+// 启动时建库建表、按版本执行迁移，并检查查询依赖的索引是否存在（缺失则补建）。
+// 用独立的 Session 连接，不经过连接池：库不存在时连接池里带 DB 参数的连接建不起来。
+class SchemaBootstrap {
+public:
+    explicit SchemaBootstrap(const PoolConfig &config);
+
+    // 执行全部步骤，任何一步失败返回 false
+    bool run();
+
+private:
+    // 查询依赖的一个索引：按 columns 顺序作为最左前缀
+    struct IndexSpec {
+        std::string table;
+        std::string name;
+        std::vector<std::string> columns;
+        bool unique;
+    };
+
+    // 一次迁移：version 递增，statements 依次执行
+    struct Migration {
+        int version;
+        std::string description;
+        std::vector<std::string> statements;
+    };
+
+    int currentVersion(mysqlx::Session &session);
+    bool migrate(mysqlx::Session &session);
+    bool verifyIndexes(mysqlx::Session &session);
+    bool hasIndex(mysqlx::Session &session, const IndexSpec &spec);
+
+    static const std::vector<Migration> &migrations();
+    static const std::vector<IndexSpec> &requiredIndexes();
+
+    PoolConfig config_;
+};
+
+#endif // SCHEMA_BOOTSTRAP_H
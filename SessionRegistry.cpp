@@ -0,0 +1,185 @@
+// SessionRegistry.cpp
+#include "SessionRegistry.h"
+#include <algorithm>
+#include <iterator>
+
+SessionRegistry::SessionRegistry(size_t shards)
+    : shardCount_(shards ? shards : 1), shards_(new Shard[shards ? shards : 1]),
+      size_(0), evictions_(0), expirations_(0), stopping_(false) {
+    applyLimits(SessionLimits());
+}
+
+SessionRegistry::~SessionRegistry() {
+    {
+        std::lock_guard<std::mutex> lock(sweepMutex_);
+        stopping_ = true;
+    }
+    sweepWake_.notify_all();
+    if (sweeper_.joinable()) {
+        sweeper_.join();
+    }
+}
+
+void SessionRegistry::configure(const SessionLimits &limits) {
+    std::lock_guard<std::mutex> lock(sweepMutex_);
+    applyLimits(limits);
+    if (!sweeper_.joinable()) {
+        sweeper_ = std::thread(&SessionRegistry::sweepLoop, this);
+    }
+}
+
+void SessionRegistry::applyLimits(const SessionLimits &limits) {
+    limits_ = limits;
+    // 每个分段至少能放一个会话
+    shardCapacity_ = std::max<size_t>(1, (limits_.capacity + shardCount_ - 1) / shardCount_);
+    ttlNs_ = std::chrono::duration_cast<std::chrono::nanoseconds>(limits_.ttl).count();
+}
+
+int64_t SessionRegistry::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool SessionRegistry::expired(const Entry &entry, int64_t now) const {
+    return now - entry.lastAccess.load(std::memory_order_relaxed) > ttlNs_;
+}
+
+std::shared_ptr<Client> SessionRegistry::lookup(int userId) const {
+    Shard &shard = shardFor(userId);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.clients.find(userId);
+    if (it == shard.clients.end()) {
+        return nullptr;
+    }
+    int64_t t = now();
+    // 过期项留给写路径或后台线程删除
+    if (expired(it->second, t)) {
+        return nullptr;
+    }
+    it->second.lastAccess.store(t, std::memory_order_relaxed);
+    return it->second.client;
+}
+
+void SessionRegistry::removeEntry(Shard &shard, std::unordered_map<int, Entry>::iterator it,
+                                  std::vector<std::shared_ptr<Client>> &removed) {
+    size_--;
+    removed.push_back(std::move(it->second.client));
+    shard.clients.erase(it);
+}
+
+void SessionRegistry::put(Shard &shard, int userId, std::shared_ptr<Client> client,
+                          std::vector<std::shared_ptr<Client>> &removed) {
+    auto it = shard.clients.find(userId);
+    if (it != shard.clients.end()) {
+        removeEntry(shard, it, removed);
+    }
+    shard.clients.emplace(std::piecewise_construct,
+                          std::forward_as_tuple(userId),
+                          std::forward_as_tuple(std::move(client), now()));
+    size_++;
+    enforceLimits(shard, userId, removed);
+}
+
+// 先清理过期项，仍超出容量时淘汰最久未访问的会话（刚插入的除外）。
+// 单个分段很小，线性扫描即可。
+void SessionRegistry::enforceLimits(Shard &shard, int keepUserId,
+                                    std::vector<std::shared_ptr<Client>> &removed) {
+    if (shard.clients.size() <= shardCapacity_) {
+        return;
+    }
+    int64_t t = now();
+    for (auto it = shard.clients.begin(); it != shard.clients.end();) {
+        auto next = std::next(it);
+        if (it->first != keepUserId && expired(it->second, t)) {
+            removeEntry(shard, it, removed);
+            expirations_++;
+        }
+        it = next;
+    }
+    while (shard.clients.size() > shardCapacity_ && shard.clients.size() > 1) {
+        auto oldest = shard.clients.end();
+        for (auto it = shard.clients.begin(); it != shard.clients.end(); ++it) {
+            if (it->first == keepUserId) {
+                continue;
+            }
+            if (oldest == shard.clients.end() ||
+                it->second.lastAccess.load(std::memory_order_relaxed) <
+                oldest->second.lastAccess.load(std::memory_order_relaxed)) {
+                oldest = it;
+            }
+        }
+        removeEntry(shard, oldest, removed);
+        evictions_++;
+    }
+}
+
+void SessionRegistry::insert(int userId, std::shared_ptr<Client> client) {
+    Shard &shard = shardFor(userId);
+    std::vector<std::shared_ptr<Client>> removed;   // 旧会话在锁外析构
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    put(shard, userId, std::move(client), removed);
+}
+
+std::shared_ptr<Client> SessionRegistry::insertIfAbsent(int userId, std::shared_ptr<Client> client) {
+    Shard &shard = shardFor(userId);
+    std::vector<std::shared_ptr<Client>> removed;
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.clients.find(userId);
+    if (it != shard.clients.end() && !expired(it->second, now())) {
+        it->second.lastAccess.store(now(), std::memory_order_relaxed);
+        return it->second.client;
+    }
+    std::shared_ptr<Client> result = client;
+    put(shard, userId, std::move(client), removed);
+    return result;
+}
+
+bool SessionRegistry::erase(int userId) {
+    Shard &shard = shardFor(userId);
+    std::vector<std::shared_ptr<Client>> removed;
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.clients.find(userId);
+    if (it == shard.clients.end()) {
+        return false;
+    }
+    removeEntry(shard, it, removed);
+    return true;
+}
+
+void SessionRegistry::evictExpired() {
+    for (size_t i = 0; i < shardCount_; i++) {
+        Shard &shard = shards_[i];
+        std::vector<std::shared_ptr<Client>> removed;
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        int64_t t = now();
+        for (auto it = shard.clients.begin(); it != shard.clients.end();) {
+            auto next = std::next(it);
+            if (expired(it->second, t)) {
+                removeEntry(shard, it, removed);
+                expirations_++;
+            }
+            it = next;
+        }
+    }
+}
+
+void SessionRegistry::sweepLoop() {
+    std::unique_lock<std::mutex> lock(sweepMutex_);
+    while (!stopping_) {
+        sweepWake_.wait_for(lock, limits_.sweepInterval);
+        if (stopping_) {
+            break;
+        }
+        lock.unlock();
+        evictExpired();
+        lock.lock();
+    }
+}
+
+SessionStats SessionRegistry::stats() const {
+    SessionStats s;
+    s.size = size_;
+    s.evictions = evictions_;
+    s.expirations = expirations_;
+    return s;
+}
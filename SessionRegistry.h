@@ -0,0 +1,105 @@
+// SessionRegistry.h
+#ifndef SESSION_REGISTRY_H
+#define SESSION_REGISTRY_H
+
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <vector>
+#include "Client.h"
+
+// 会话表的容量限制
+struct SessionLimits {
+    size_t capacity = 100000;                  // 最多缓存的会话数
+    std::chrono::seconds ttl{3600};            // 超过该时间未访问的会话视为过期
+    std::chrono::seconds sweepInterval{60};    // 后台清理过期会话的周期
+};
+
+// 会话表运行指标快照
+struct SessionStats {
+    size_t size = 0;
+    uint64_t evictions = 0;     // 因容量被淘汰
+    uint64_t expirations = 0;   // 因 TTL 过期被清理
+};
+
+// 已登录用户的会话表，所有 httplib 工作线程并发读写。
+// 按用户ID分成若干分段，每段一把读写锁：查找只加读锁，不同分段的写互不影响。
+// 容量平均分到各分段，超出时淘汰分段内最久未访问的会话（近似 LRU：
+// 访问时间用原子变量记录，查找路径不需要写锁）。被淘汰的用户下次请求时凭 token 重新加载。
+// 会话只有固定大小的用户信息，随数据增长的任务列表在 TaskCache 里，由它自己的内存预算限制，
+// 所以这里只限制会话数，不再单独设内存预算。
+class SessionRegistry {
+public:
+    explicit SessionRegistry(size_t shards = 64);
+    ~SessionRegistry();
+
+    SessionRegistry(const SessionRegistry&) = delete;
+    SessionRegistry& operator=(const SessionRegistry&) = delete;
+
+    // 在开始处理请求前调用，同时启动后台清理线程
+    void configure(const SessionLimits &limits);
+
+    // 不存在或已过期时返回空指针，不会插入空项
+    std::shared_ptr<Client> lookup(int userId) const;
+    // 已存在则覆盖
+    void insert(int userId, std::shared_ptr<Client> client);
+    // 已存在（且未过期）则保留原会话并返回它，否则插入并返回 client
+    std::shared_ptr<Client> insertIfAbsent(int userId, std::shared_ptr<Client> client);
+    bool erase(int userId);
+    size_t size() const { return size_; }
+
+    // 清理所有分段中的过期会话
+    void evictExpired();
+
+    SessionStats stats() const;
+
+private:
+    struct Entry {
+        Entry(std::shared_ptr<Client> c, int64_t now)
+            : client(std::move(c)), lastAccess(now) {}
+
+        std::shared_ptr<Client> client;
+        mutable std::atomic<int64_t> lastAccess;   // steady_clock 纳秒
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<int, Entry> clients;
+    };
+
+    Shard &shardFor(int userId) const { return shards_[static_cast<unsigned>(userId) % shardCount_]; }
+    static int64_t now();
+    bool expired(const Entry &entry, int64_t now) const;
+    void applyLimits(const SessionLimits &limits);
+
+    // 以下函数调用方需持有分段写锁，被移除的会话放进 removed，在锁外析构
+    void put(Shard &shard, int userId, std::shared_ptr<Client> client,
+             std::vector<std::shared_ptr<Client>> &removed);
+    void removeEntry(Shard &shard, std::unordered_map<int, Entry>::iterator it,
+                     std::vector<std::shared_ptr<Client>> &removed);
+    void enforceLimits(Shard &shard, int keepUserId, std::vector<std::shared_ptr<Client>> &removed);
+
+    void sweepLoop();
+
+    size_t shardCount_;
+    std::unique_ptr<Shard[]> shards_;
+    SessionLimits limits_;
+    size_t shardCapacity_;
+    int64_t ttlNs_;
+
+    std::atomic<size_t> size_;
+    std::atomic<uint64_t> evictions_;
+    std::atomic<uint64_t> expirations_;
+
+    std::mutex sweepMutex_;
+    std::condition_variable sweepWake_;
+    bool stopping_;
+    std::thread sweeper_;
+};
+
+#endif // SESSION_REGISTRY_H
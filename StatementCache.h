@@ -0,0 +1,73 @@
+// StatementCache.h
+#ifndef STATEMENT_CACHE_H
+#define STATEMENT_CACHE_H
+
+#include <string>
+#include <mysqlx/xdevapi.h>
+
+// 每条连接各自持有的 Schema/Table 句柄和可复用的 CRUD 语句。
+// 同一个语句对象只改 bind 再次 execute 时，X DevAPI 会自动在服务端 prepare，
+// 之后的执行只传参数，省掉重复解析。语句绑定在所属连接上，只能由借到该连接的线程使用。
+// 任务查询都只按 tasks.user_id 过滤、按 (created_at, id) 倒序，
+// 由 idx_tasks_user_created(user_id, created_at, id) 直接倒序扫描得到（不排序），
+// 其余列按主键回表读取，该索引不覆盖这些查询，见 SchemaBootstrap。
+struct StatementCache {
+    StatementCache(mysqlx::Session &session, const std::string &database)
+        : schema(session.getSchema(database)),
+          users(schema.getTable("users")),
+          tasks(schema.getTable("tasks")),
+          userExists(users.select("id")
+                     .where("username = :username OR email = :email")),
+          userIdByName(users.select("id")
+                       .where("username = :username")),
+          userByName(users.select("id", "username", "email",
+                                  "password_hash", "CAST(created_at AS CHAR)")
+                     .where("username = :username")),
+          userById(users.select("id", "username", "email",
+                                "password_hash", "CAST(created_at AS CHAR)")
+                   .where("id = :id")),
+          tasksByUser(tasks.select("id", "title", "description", "completed",
+                                   "CAST(due_date AS CHAR)", "CAST(created_at AS CHAR)")
+                      .where("user_id = :user_id")
+                      .orderBy("created_at DESC", "id DESC")),
+          taskById(tasks.select("id", "title", "description", "completed",
+                                "CAST(due_date AS CHAR)", "CAST(created_at AS CHAR)")
+                   .where("id = :id AND user_id = :user_id")),
+          tasksPageFirst(tasks.select("id", "title", "description", "completed",
+                                      "CAST(due_date AS CHAR)", "CAST(created_at AS CHAR)")
+                         .where("user_id = :user_id")
+                         .orderBy("created_at DESC", "id DESC")),
+          tasksPageAfter(tasks.select("id", "title", "description", "completed",
+                                      "CAST(due_date AS CHAR)", "CAST(created_at AS CHAR)")
+                         .where("user_id = :user_id AND (created_at < :created_at "
+                                "OR (created_at = :created_at AND id < :id))")
+                         .orderBy("created_at DESC", "id DESC")),
+          deleteTask(tasks.remove()
+                     .where("id = :id AND user_id = :user_id")),
+          updateTaskStatus(tasks.update()
+                           .set("completed", mysqlx::expr(":completed"))
+                           .where("id = :id AND user_id = :user_id")) {
+        // 多行 INSERT 的ID按该步长连续分配，每条连接只查一次
+        mysqlx::Row row = session.sql("SELECT @@SESSION.auto_increment_increment").execute().fetchOne();
+        autoIncrementStep = row[0].get<int>();
+    }
+
+    mysqlx::Schema schema;
+    mysqlx::Table users;
+    mysqlx::Table tasks;
+
+    mysqlx::TableSelect userExists;
+    mysqlx::TableSelect userIdByName;
+    mysqlx::TableSelect userByName;
+    mysqlx::TableSelect userById;
+    mysqlx::TableSelect tasksByUser;
+    mysqlx::TableSelect taskById;
+    mysqlx::TableSelect tasksPageFirst;
+    mysqlx::TableSelect tasksPageAfter;
+    mysqlx::TableRemove deleteTask;
+    mysqlx::TableUpdate updateTaskStatus;
+
+    int autoIncrementStep = 1;
+};
+
+#endif // STATEMENT_CACHE_H
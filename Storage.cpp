@@ -0,0 +1,111 @@
+// Storage.cpp
+#include "Storage.h"
+#include "Database.h"
+#include "MemoryStorage.h"
+#include <memory>
+#include <map>
+#include <iostream>
+#include <jwt-cpp/base.h>
+
+static std::unique_ptr<Storage> g_storage;
+static std::string g_backend;
+
+bool Storage::select(const std::string &backend) {
+    if (g_storage) {
+        return backend == g_backend;
+    }
+    if (backend == "mysql") {
+        g_storage.reset(new Database());
+    } else if (backend == "memory") {
+        g_storage.reset(new MemoryStorage());
+    } else {
+        std::cerr << "未知的存储后端: " << backend << std::endl;
+        return false;
+    }
+    g_backend = backend;
+    std::cout << "存储后端: " << g_backend << std::endl;
+    return true;
+}
+
+const std::string &Storage::backendName() {
+    return g_backend;
+}
+
+Storage& Storage::getInstance() {
+    if (!g_storage) {
+        select("mysql");
+    }
+    return *g_storage;
+}
+
+std::string Storage::encodeTaskCursor(const Task &t) {
+    return jwt::base::trim<jwt::alphabet::base64url>(
+        jwt::base::encode<jwt::alphabet::base64url>(t.timestamp + "|" + std::to_string(t.id)));
+}
+
+bool Storage::decodeTaskCursor(const std::string &cursor, std::string &createdAt, int &taskId) {
+    try {
+        std::string raw = jwt::base::decode<jwt::alphabet::base64url>(
+            jwt::base::pad<jwt::alphabet::base64url>(cursor));
+        size_t sep = raw.rfind('|');
+        if (sep == std::string::npos || sep == 0 || sep + 1 == raw.size()) {
+            return false;
+        }
+        size_t used = 0;
+        taskId = std::stoi(raw.substr(sep + 1), &used);
+        if (used != raw.size() - sep - 1) {
+            return false;
+        }
+        createdAt = raw.substr(0, sep);
+        return true;
+    } catch (const std::exception &e) {
+        return false;
+    }
+}
+
+bool Storage::planTaskBatch(const std::vector<TaskOp> &ops, const std::unordered_set<int> &existing,
+                            TaskBatchPlan &plan, std::vector<TaskOpResult> &results) {
+    results.assign(ops.size(), TaskOpResult());
+    // 任务ID -> 最终是否完成；被修改过的任务才出现在这里
+    std::map<int, bool> updated;
+    std::unordered_set<int> deleted;
+    bool ok = true;
+
+    for (size_t i = 0; i < ops.size(); i++) {
+        const TaskOp &op = ops[i];
+        TaskOpResult &result = results[i];
+        result.taskId = op.taskId;
+        if (op.type == TaskOp::Create) {
+            plan.creates.push_back(op.task);
+            plan.createOps.push_back(i);
+            result.status = 201;
+            continue;
+        }
+        if (existing.count(op.taskId) == 0 || deleted.count(op.taskId) != 0) {
+            result.status = 404;
+            ok = false;
+            continue;
+        }
+        if (op.type == TaskOp::Update) {
+            updated[op.taskId] = op.completed;
+        } else {
+            updated.erase(op.taskId);
+            deleted.insert(op.taskId);
+        }
+        result.status = 200;
+    }
+
+    if (!ok) {
+        for (TaskOpResult &result : results) {
+            if (result.status != 404) {
+                result.status = 409;
+            }
+        }
+        return false;
+    }
+    for (const auto &item : updated) {
+        (item.second ? plan.markCompleted : plan.markPending).push_back(item.first);
+    }
+    plan.deletes.assign(deleted.begin(), deleted.end());
+    return true;
+}
@@ -0,0 +1,124 @@
+// Storage.h
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <string> // 明确包含 std::string
+#include <vector>
+#include <functional>
+#include <unordered_set>
+
+class Task {
+public:
+    Task() : id(0), completed(false) {}
+    ~Task() {}
+
+    // 估算占用的堆内存（字节），用于缓存的内存预算
+    size_t memoryUsage() const {
+        return sizeof(Task) + title.capacity() + text.capacity() +
+               datetime.capacity() + timestamp.capacity();
+    }
+
+//private:
+    int id;
+    std::string title;
+    std::string text;
+    bool completed;
+    std::string datetime;
+    std::string timestamp;
+};
+
+class User {
+public:
+    User() : id(-1) {}
+    ~User() {}
+
+//private:
+    int id;
+    std::string username;
+    std::string email;
+    std::string timestamp;
+    std::string password_hash;
+    std::vector<Task> task;
+};
+
+// 一页任务，nextCursor 为空表示已经是最后一页
+struct TaskPage {
+    std::vector<Task> tasks;
+    std::string nextCursor;
+};
+
+// 分页查询的结果：游标无法解析是客户端的错，数据库出错是服务端的错，分开返回
+enum class PageResult { Ok, InvalidCursor, Error };
+
+// 批量修改中的一个操作
+struct TaskOp {
+    enum Type { Create, Update, Delete };
+
+    Type type = Create;
+    int taskId = 0;           // Update / Delete 的目标任务
+    bool completed = false;   // Update 的新状态
+    Task task;                // Create 的新任务
+};
+
+// 单个操作的结果，status 沿用 HTTP 状态码的含义：
+// 201 已新建、200 已修改/删除、404 任务不存在、409 本身没问题但同批其它操作失败，整批未执行
+struct TaskOpResult {
+    int status = 0;
+    int taskId = 0;
+    Task task;                // Create / Update 成功时为修改后的任务
+};
+
+// 批量操作按提交顺序作用在已有任务上的最终效果，用集合语句一次执行
+struct TaskBatchPlan {
+    std::vector<Task> creates;
+    std::vector<size_t> createOps;      // creates[i] 对应的操作下标
+    std::vector<int> markCompleted;     // 最终状态为已完成的任务
+    std::vector<int> markPending;       // 最终状态为未完成的任务
+    std::vector<int> deletes;
+};
+
+// 存储后端接口。Database 是 MySQL 实现，MemoryStorage 是纯内存实现，
+// 启动时通过 Storage::select() 选定，之后所有请求共用同一个后端实例。
+class Storage {
+public:
+    virtual ~Storage() {}
+
+    virtual bool connect() = 0;
+    virtual void disconnect() = 0;
+    virtual bool registerUser(const std::string &username, const std::string &email, const std::string &password) = 0;
+    virtual bool loginUser(const std::string &username, const std::string &password, User &user) = 0;
+    virtual int addTask(int id, const Task &t) = 0;
+    virtual std::vector<int> addTasks(int id, const std::vector<Task> &tasks) = 0;
+    virtual bool delTask(int userId, int taskId) = 0;
+    virtual bool updateTaskStatus(int userId, int taskId, bool completed) = 0;
+    // 读取单个任务（必须属于该用户），不存在时返回 false
+    virtual bool getTask(int userId, int taskId, Task &task) = 0;
+    virtual std::vector<Task> getUserTasks(int id) = 0;
+    virtual PageResult getUserTasksPage(int id, size_t limit, const std::string &after, TaskPage &page) = 0;
+    virtual bool streamUserTasks(int id, const std::function<bool(const Task&)> &onTask) = 0;
+    virtual User getUser(const std::string &username) = 0;
+    virtual User getUser(int id) = 0;
+    virtual int getIdByName(const std::string &username) = 0;
+
+    // 在一个事务中执行一批新建/修改/删除，results 与 ops 一一对应。
+    // 全部成功提交返回 true；有操作引用了不存在的任务时整批回滚、返回 false，
+    // results 中标出失败的操作；数据库出错时返回 false 且 results 为空。
+    virtual bool applyTaskBatch(int userId, const std::vector<TaskOp> &ops, std::vector<TaskOpResult> &results) = 0;
+
+    // 选择后端："mysql"（默认）或 "memory"，只能在处理请求前调用一次
+    static bool select(const std::string &backend);
+    static const std::string &backendName();
+    static Storage& getInstance();
+
+protected:
+    // 分页游标编解码，格式: base64url("created_at|id")，对客户端不透明
+    static std::string encodeTaskCursor(const Task &t);
+    static bool decodeTaskCursor(const std::string &cursor, std::string &createdAt, int &taskId);
+
+    // 按提交顺序推演一批操作（同一任务可以先改后删），existing 为涉及的已有任务ID。
+    // 有操作失败时返回 false，并把其余操作的结果标为 409
+    static bool planTaskBatch(const std::vector<TaskOp> &ops, const std::unordered_set<int> &existing,
+                              TaskBatchPlan &plan, std::vector<TaskOpResult> &results);
+};
+
+#endif // STORAGE_H
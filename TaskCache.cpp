@@ -0,0 +1,165 @@
+// TaskCache.cpp
+#include "TaskCache.h"
+#include <algorithm>
+
+TaskCache& TaskCache::getInstance() {
+    static TaskCache instance;
+    return instance;
+}
+
+TaskCache::TaskCache()
+    : capacity_(10000), maxBytes_(128 * 1024 * 1024), bytes_(0),
+      hits_(0), misses_(0), evictions_(0),
+      invalidations_(0), updates_(0) {
+}
+
+void TaskCache::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    evictIfNeeded();
+}
+
+void TaskCache::setMaxBytes(size_t maxBytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxBytes_ = maxBytes;
+    evictIfNeeded();
+}
+
+size_t TaskCache::listBytes(const std::vector<Task> &tasks) {
+    size_t bytes = sizeof(std::vector<Task>) + (tasks.capacity() - tasks.size()) * sizeof(Task);
+    for (const Task &t : tasks) {
+        bytes += t.memoryUsage();
+    }
+    return bytes;
+}
+
+void TaskCache::replaceTasks(Entry &entry, TaskList tasks) {
+    size_t bytes = listBytes(*tasks);
+    bytes_ = bytes_ - entry.bytes + bytes;
+    entry.bytes = bytes;
+    entry.tasks = std::move(tasks);
+}
+
+TaskCache::TaskList TaskCache::get(int userId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(userId);
+    if (it == entries_.end()) {
+        misses_++;
+        return TaskList();
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    hits_++;
+    return it->second.tasks;
+}
+
+void TaskCache::beginLoad(int userId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &state = loading_[userId];
+    state.first++;
+}
+
+void TaskCache::endLoad(int userId, std::vector<Task> tasks, bool success) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto loading = loading_.find(userId);
+    bool written = loading != loading_.end() && loading->second.second;
+    if (loading != loading_.end() && --loading->second.first == 0) {
+        loading_.erase(loading);
+    }
+    if (!success || written || capacity_ == 0) {
+        return;
+    }
+
+    TaskList list = std::make_shared<const std::vector<Task>>(std::move(tasks));
+    auto it = entries_.find(userId);
+    if (it != entries_.end()) {
+        replaceTasks(it->second, list);
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+    } else {
+        lru_.push_front(userId);
+        Entry &entry = entries_[userId];
+        entry.bytes = 0;
+        entry.lru = lru_.begin();
+        replaceTasks(entry, list);
+    }
+    // 单个用户的列表超出整个预算时也会被淘汰，下次请求直接回源
+    evictIfNeeded();
+}
+
+void TaskCache::markWritten(int userId) {
+    auto loading = loading_.find(userId);
+    if (loading != loading_.end()) {
+        loading->second.second = true;
+    }
+}
+
+void TaskCache::evictIfNeeded() {
+    while (!lru_.empty() && (entries_.size() > capacity_ || bytes_ > maxBytes_)) {
+        auto it = entries_.find(lru_.back());
+        bytes_ -= it->second.bytes;
+        entries_.erase(it);
+        lru_.pop_back();
+        evictions_++;
+    }
+}
+
+void TaskCache::invalidate(int userId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    markWritten(userId);
+    auto it = entries_.find(userId);
+    if (it != entries_.end()) {
+        bytes_ -= it->second.bytes;
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+        invalidations_++;
+    }
+}
+
+// 缓存中的列表是只读共享的，修改时复制一份再替换（读者手里的旧列表不受影响）
+void TaskCache::removeTask(int userId, int taskId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    markWritten(userId);
+    auto it = entries_.find(userId);
+    if (it == entries_.end()) {
+        return;
+    }
+    std::shared_ptr<std::vector<Task>> copy = std::make_shared<std::vector<Task>>(*it->second.tasks);
+    copy->erase(std::remove_if(copy->begin(), copy->end(),
+                               [taskId](const Task &t) { return t.id == taskId; }),
+                copy->end());
+    replaceTasks(it->second, copy);
+    updates_++;
+}
+
+void TaskCache::setTaskCompleted(int userId, int taskId, bool completed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    markWritten(userId);
+    auto it = entries_.find(userId);
+    if (it == entries_.end()) {
+        return;
+    }
+    std::shared_ptr<std::vector<Task>> copy = std::make_shared<std::vector<Task>>(*it->second.tasks);
+    for (Task &t : *copy) {
+        if (t.id == taskId) {
+            t.completed = completed;
+        }
+    }
+    replaceTasks(it->second, copy);
+    updates_++;
+}
+
+TaskCacheStats TaskCache::stats() const {
+    TaskCacheStats s;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        s.entries = entries_.size();
+        s.capacity = capacity_;
+        s.bytes = bytes_;
+        s.maxBytes = maxBytes_;
+    }
+    s.hits = hits_;
+    s.misses = misses_;
+    s.evictions = evictions_;
+    s.invalidations = invalidations_;
+    s.updates = updates_;
+    return s;
+}
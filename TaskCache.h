@@ -0,0 +1,88 @@
+// TaskCache.h
+#ifndef TASK_CACHE_H
+#define TASK_CACHE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+#include "Database.h"
+
+// 缓存运行指标快照
+struct TaskCacheStats {
+    size_t entries = 0;
+    size_t capacity = 0;
+    size_t bytes = 0;          // 缓存的任务数据估算占用
+    size_t maxBytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t invalidations = 0;
+    uint64_t updates = 0;      // 写操作直接修改缓存的次数
+};
+
+// 按用户ID缓存任务列表（LRU），放在 Database::getUserTasks 前面。
+// 读多写少：前端每次增删改后都会重新拉取列表。
+// 写操作按任务ID精确修改缓存，无法精确修改时（新增任务，created_at 由数据库生成）整项失效。
+class TaskCache {
+public:
+    typedef std::shared_ptr<const std::vector<Task>> TaskList;
+
+    TaskCache(const TaskCache&) = delete;
+    TaskCache& operator=(const TaskCache&) = delete;
+
+    static TaskCache& getInstance();
+
+    void setCapacity(size_t capacity);
+    // 任务数据的内存预算（字节），超出时按 LRU 淘汰
+    void setMaxBytes(size_t maxBytes);
+
+    // 命中返回缓存的列表，未命中返回空指针
+    TaskList get(int userId);
+
+    // 未命中时的回源流程：beginLoad -> 查数据库 -> endLoad。
+    // 回源期间该用户如果有写操作，endLoad 不会写入已过期的结果。
+    void beginLoad(int userId);
+    void endLoad(int userId, std::vector<Task> tasks, bool success);
+
+    void invalidate(int userId);
+    void removeTask(int userId, int taskId);
+    void setTaskCompleted(int userId, int taskId, bool completed);
+
+    TaskCacheStats stats() const;
+
+private:
+    TaskCache();
+    ~TaskCache() = default;
+
+    struct Entry {
+        TaskList tasks;
+        size_t bytes;
+        std::list<int>::iterator lru;
+    };
+
+    static size_t listBytes(const std::vector<Task> &tasks);
+
+    // 调用方需持有 mutex_
+    void markWritten(int userId);
+    void replaceTasks(Entry &entry, TaskList tasks);
+    void evictIfNeeded();
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    size_t maxBytes_;
+    size_t bytes_;
+    std::list<int> lru_;                          // 头部为最近使用
+    std::unordered_map<int, Entry> entries_;
+    std::unordered_map<int, std::pair<int, bool>> loading_;   // userId -> (回源中的请求数, 期间是否被写过)
+
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::atomic<uint64_t> evictions_;
+    std::atomic<uint64_t> invalidations_;
+    std::atomic<uint64_t> updates_;
+};
+
+#endif // TASK_CACHE_H
@@ -0,0 +1,119 @@
+// TokenCache.cpp
+#include "TokenCache.h"
+#include <cstring>
+#include <mutex>
+#include <openssl/crypto.h>
+#include <openssl/sha.h>
+
+TokenCache& TokenCache::getInstance() {
+    static TokenCache instance;
+    return instance;
+}
+
+TokenCache::TokenCache()
+    : shardCapacity_((100000 + kShards - 1) / kShards), hits_(0), misses_(0),
+      evictions_(0), revokedRejects_(0) {
+}
+
+void TokenCache::setCapacity(size_t capacity) {
+    shardCapacity_ = (capacity + kShards - 1) / kShards;
+}
+
+TokenCache::Digest TokenCache::digest(const char *signingInput, size_t len) {
+    Digest d;
+    SHA256(reinterpret_cast<const unsigned char *>(signingInput), len, d.data());
+    return d;
+}
+
+TokenCache::Result TokenCache::lookup(const Digest &key, const Signature &signature, int64_t now,
+                                      TokenClaims &claims) {
+    Shard &shard = shardFor(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto revoked = shard.revoked.find(key);
+    if (revoked != shard.revoked.end() && revoked->second > now) {
+        revokedRejects_.fetch_add(1, std::memory_order_relaxed);
+        return Result::Revoked;
+    }
+    auto it = shard.entries.find(key);
+    // 过期的项留给插入时淘汰，这里只当作未命中；签名不同说明是伪造的，交给完整校验去拒绝
+    if (it == shard.entries.end() || it->second.claims.expiresAt <= now ||
+        CRYPTO_memcmp(it->second.signature.data(), signature.data(), signature.size()) != 0) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return Result::Miss;
+    }
+    claims = it->second.claims;
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return Result::Hit;
+}
+
+void TokenCache::insert(const Digest &key, const Signature &signature, const TokenClaims &claims, int64_t now) {
+    size_t capacity = shardCapacity_.load(std::memory_order_relaxed);
+    if (capacity == 0 || claims.expiresAt <= now) {
+        return;
+    }
+    Shard &shard = shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    if (shard.revoked.count(key)) {
+        return;
+    }
+    if (!shard.entries.emplace(key, Entry{signature, claims}).second) {
+        return;
+    }
+    shard.order.push_back(key);
+    // 队首是最早插入的；已经被注销移除的摘要直接跳过
+    while (shard.entries.size() > capacity && !shard.order.empty()) {
+        auto it = shard.entries.find(shard.order.front());
+        shard.order.pop_front();
+        if (it != shard.entries.end()) {
+            if (it->second.claims.expiresAt > now) {
+                evictions_.fetch_add(1, std::memory_order_relaxed);
+            }
+            shard.entries.erase(it);
+        }
+    }
+    // 注销移除的项在 order 中留下空位，积累过多时重建
+    if (shard.order.size() > 2 * shard.entries.size() + 64) {
+        std::deque<Digest> live;
+        for (const Digest &d : shard.order) {
+            if (shard.entries.count(d)) {
+                live.push_back(d);
+            }
+        }
+        shard.order.swap(live);
+    }
+}
+
+void TokenCache::revoke(const Digest &key, int64_t expiresAt, int64_t now) {
+    if (expiresAt <= now) {
+        return;
+    }
+    Shard &shard = shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    pruneRevoked(shard, now);
+    shard.revoked[key] = expiresAt;
+    shard.entries.erase(key);
+}
+
+void TokenCache::pruneRevoked(Shard &shard, int64_t now) {
+    for (auto it = shard.revoked.begin(); it != shard.revoked.end();) {
+        if (it->second <= now) {
+            it = shard.revoked.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+TokenCacheStats TokenCache::stats() const {
+    TokenCacheStats s;
+    for (const Shard &shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        s.entries += shard.entries.size();
+        s.revoked += shard.revoked.size();
+    }
+    s.hits = hits_;
+    s.misses = misses_;
+    s.evictions = evictions_;
+    s.revokedRejects = revokedRejects_;
+    return s;
+}
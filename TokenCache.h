@@ -0,0 +1,104 @@
+// TokenCache.h
+#ifndef TOKEN_CACHE_H
+#define TOKEN_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// 校验通过的 token 中的声明
+struct TokenClaims {
+    int userId = -1;
+    std::string username;
+    int64_t expiresAt = 0;      // exp，Unix 秒
+};
+
+// 缓存运行指标快照
+struct TokenCacheStats {
+    size_t entries = 0;
+    size_t revoked = 0;          // 尚未过期的已注销 token
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t revokedRejects = 0; // 因已注销被拒绝的请求
+};
+
+// 已校验 token 的缓存：签名输入（header.payload 原文）的 SHA-256 摘要 -> 解码后的签名、声明和过期时间。
+// 同一个浏览器每小时会带着同一个 token 请求几百次，命中时跳过 base64 解码、JSON 解析和 HMAC 校验。
+// 不按整个 token 字符串索引：签名的 base64url 末位字符有不参与解码的低位，
+// 同一个签名可以有多种写法，按原文索引的注销可以被这样绕过。签名输入被 HMAC 覆盖，不能改写；
+// 签名由调用方严格解码（拒绝非规范写法）后传入，命中时再逐字节比较。
+// 缓存只存摘要不存 token 原文。按摘要分段，每段一把读写锁；段满时按插入顺序淘汰
+// （token 有效期相同，插入顺序基本就是过期顺序）。
+// 注销的 token 记入同一分段的注销表直到过期，之后无论是否命中缓存都会被拒绝。
+class TokenCache {
+public:
+    typedef std::array<unsigned char, 32> Digest;
+    typedef std::array<unsigned char, 32> Signature;    // 解码后的 HS256 签名
+
+    TokenCache(const TokenCache&) = delete;
+    TokenCache& operator=(const TokenCache&) = delete;
+
+    static TokenCache& getInstance();
+
+    // 启动前调用；0 表示关闭缓存（注销表仍然生效）
+    void setCapacity(size_t capacity);
+
+    // 签名输入的摘要，作为缓存和注销表的键
+    static Digest digest(const char *signingInput, size_t len);
+
+    enum class Result { Hit, Miss, Revoked };
+    // 命中、签名一致且未过期时填写 claims；同一签名输入已注销时不论签名都返回 Revoked
+    Result lookup(const Digest &key, const Signature &signature, int64_t now, TokenClaims &claims);
+    void insert(const Digest &key, const Signature &signature, const TokenClaims &claims, int64_t now);
+    // 注销到 expiresAt 为止，同时移出缓存
+    void revoke(const Digest &key, int64_t expiresAt, int64_t now);
+
+    TokenCacheStats stats() const;
+
+private:
+    TokenCache();
+    ~TokenCache() = default;
+
+    struct DigestHash {
+        size_t operator()(const Digest &d) const {
+            // 摘要本身是均匀分布的，直接取前 8 字节
+            size_t h;
+            std::memcpy(&h, d.data(), sizeof(h));
+            return h;
+        }
+    };
+
+    struct Entry {
+        Signature signature;
+        TokenClaims claims;
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<Digest, Entry, DigestHash> entries;
+        std::deque<Digest> order;                                 // 插入顺序，可能含已删除的项
+        std::unordered_map<Digest, int64_t, DigestHash> revoked;  // 摘要 -> 过期时间
+    };
+
+    static const size_t kShards = 16;
+
+    Shard &shardFor(const Digest &key) { return shards_[key[31] % kShards]; }
+    // 调用方需持有该分段的写锁
+    void pruneRevoked(Shard &shard, int64_t now);
+
+    Shard shards_[kShards];
+    std::atomic<size_t> shardCapacity_;
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::atomic<uint64_t> evictions_;
+    std::atomic<uint64_t> revokedRejects_;
+};
+
+#endif // TOKEN_CACHE_H
@@ -0,0 +1,86 @@
+// bench/executor_bench.cpp
+// 对比 LockFreeTaskQueue 和 httplib::ThreadPool：producers 个线程（相当于 accept 线程和
+// keep-alive 反应器线程）各提交 jobs 个任务，每个任务忙等 workUs 微秒。
+// 输出吞吐量，以及从提交到开始执行的排队时间 p50/p99/max。
+// 用法: ./bench/executor_bench [工作线程数=8] [提交线程数=2] [每个提交线程的任务数=200000] [任务耗时us=0]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "httplib.h"
+#include "LockFreeTaskQueue.h"
+
+using Clock = std::chrono::steady_clock;
+
+static void spin(int us) {
+    if (us <= 0) {
+        return;
+    }
+    auto until = Clock::now() + std::chrono::microseconds(us);
+    while (Clock::now() < until) {
+    }
+}
+
+static void run(const char *name, httplib::TaskQueue *queue, int producers, int jobs, int workUs) {
+    size_t total = static_cast<size_t>(producers) * jobs;
+    std::vector<uint32_t> waits(total);     // 每个任务的排队时间（纳秒，截断到 32 位）
+    std::atomic<size_t> done(0);
+    std::atomic<size_t> rejected(0);
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < jobs; i++) {
+                size_t slot = static_cast<size_t>(p) * jobs + i;
+                auto enqueued = Clock::now();
+                // 队列满时重试，和 accept 线程被拒绝后客户端重连的效果相近
+                while (!queue->enqueue([&, slot, enqueued] {
+                    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - enqueued).count();
+                    waits[slot] = static_cast<uint32_t>(std::min<long long>(ns, UINT32_MAX));
+                    spin(workUs);
+                    done.fetch_add(1, std::memory_order_relaxed);
+                })) {
+                    rejected.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    while (done.load(std::memory_order_relaxed) < total) {
+        std::this_thread::yield();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    queue->shutdown();
+
+    std::sort(waits.begin(), waits.end());
+    std::printf("%-12s %10.0f jobs/s  wait p50=%7.1fus p99=%8.1fus max=%9.1fus  rejected=%zu\n",
+                name, total / seconds,
+                waits[total / 2] / 1000.0, waits[total * 99 / 100] / 1000.0, waits[total - 1] / 1000.0,
+                rejected.load());
+}
+
+int main(int argc, char **argv) {
+    size_t workers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+    int producers = argc > 2 ? std::atoi(argv[2]) : 2;
+    int jobs = argc > 3 ? std::atoi(argv[3]) : 200000;
+    int workUs = argc > 4 ? std::atoi(argv[4]) : 0;
+    const size_t capacity = 4096;
+
+    std::printf("workers=%zu producers=%d jobs=%d work=%dus cpus=%u\n",
+                workers, producers, producers * jobs, workUs, std::thread::hardware_concurrency());
+    for (int round = 0; round < 2; round++) {
+        std::unique_ptr<httplib::TaskQueue> pool(new httplib::ThreadPool(workers, capacity));
+        run("threadpool", pool.get(), producers, jobs, workUs);
+        std::unique_ptr<httplib::TaskQueue> lockFree(new LockFreeTaskQueue(workers, capacity));
+        run("lockfree", lockFree.get(), producers, jobs, workUs);
+    }
+    return 0;
+}
@@ -0,0 +1,258 @@
+// bench/io_uring_bench.cpp
+// 同样的 keep-alive 负载分别压 httplib 的三种服务方式：经典模式、经典模式 + keep-alive 反应器、
+// io_uring 模式（需要 make bench IO_URING=1）。经典模式下 keep-alive 连接一直占着工作线程，
+// 所以线程池开到和连接数一样大，否则多出来的连接要等别的连接空闲超时才能被处理；另外两种用默认线程池。
+// connections 个客户端连接各自循环发 GET /ping 并等响应，持续 seconds 秒，输出每秒请求数和每个请求的系统调用数。
+// 系统调用数只算服务端：本文件重新定义了 recv/send/read/write/poll/select/epoll_wait/accept4/close，
+// 计数后转给 libc；客户端用 sendto/recvfrom，不计入。io_uring_enter 取自 Server::io_uring_stats()。
+// futex 等线程同步的系统调用不在统计内。
+// 用法: ./bench/io_uring_bench [连接数=64] [秒数=3] [io_uring 线程数=1]
+#include <arpa/inet.h>
+#include <dlfcn.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "httplib.h"
+
+using Clock = std::chrono::steady_clock;
+
+// 服务端系统调用计数
+enum SyscallKind { kRecv, kSend, kWait, kOther, kKinds };
+static std::atomic<uint64_t> g_syscalls[kKinds];
+
+template<typename F>
+static F realFunction(const char *name) {
+    return reinterpret_cast<F>(dlsym(RTLD_NEXT, name));
+}
+
+#define COUNTED(kind, ret, name, params, args)                                       \
+    extern "C" ret name params {                                                     \
+        typedef ret (*Fn) params;                                                    \
+        static Fn real = realFunction<Fn>(#name);                                    \
+        g_syscalls[kind].fetch_add(1, std::memory_order_relaxed);                    \
+        return real args;                                                            \
+    }
+
+COUNTED(kRecv, ssize_t, recv, (int fd, void *buf, size_t len, int flags), (fd, buf, len, flags))
+COUNTED(kSend, ssize_t, send, (int fd, const void *buf, size_t len, int flags), (fd, buf, len, flags))
+COUNTED(kRecv, ssize_t, read, (int fd, void *buf, size_t len), (fd, buf, len))
+COUNTED(kSend, ssize_t, write, (int fd, const void *buf, size_t len), (fd, buf, len))
+COUNTED(kWait, int, poll, (struct pollfd *fds, nfds_t nfds, int timeout), (fds, nfds, timeout))
+COUNTED(kWait, int, select, (int n, fd_set *r, fd_set *w, fd_set *e, struct timeval *tv), (n, r, w, e, tv))
+COUNTED(kWait, int, epoll_wait, (int epfd, struct epoll_event *events, int max, int timeout),
+        (epfd, events, max, timeout))
+COUNTED(kOther, int, accept4, (int fd, struct sockaddr *addr, socklen_t *len, int flags), (fd, addr, len, flags))
+COUNTED(kOther, int, close, (int fd), (fd))
+
+struct Snapshot {
+    uint64_t calls[kKinds];
+    uint64_t enters;
+};
+
+static Snapshot snapshot(const httplib::Server &server) {
+    Snapshot s;
+    for (int i = 0; i < kKinds; i++) {
+        s.calls[i] = g_syscalls[i].load();
+    }
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+    s.enters = server.io_uring_stats().enters;
+#else
+    (void)server;
+    s.enters = 0;
+#endif
+    return s;
+}
+
+// 一个 keep-alive 连接：发请求、收完整个响应（按 Content-Length），服务端关闭时重连
+class BenchClient {
+public:
+    explicit BenchClient(int port) : port_(port), fd_(-1) {}
+    BenchClient(const BenchClient &) = delete;
+    BenchClient &operator=(const BenchClient &) = delete;
+    // 在结束计数之后析构
+    ~BenchClient() {
+        abandoned_.push_back(fd_);
+        for (int fd : abandoned_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    bool connect() {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port_));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return ::connect(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0;
+    }
+
+    // 返回 false 表示连接被关闭，需要重连
+    bool roundTrip() {
+        static const char kRequest[] = "GET /ping HTTP/1.1\r\nHost: bench\r\n\r\n";
+        if (::sendto(fd_, kRequest, sizeof(kRequest) - 1, MSG_NOSIGNAL, nullptr, 0) < 0) {
+            return false;
+        }
+        std::string in;
+        char buf[4096];
+        size_t headerEnd = std::string::npos;
+        size_t total = 0;
+        for (;;) {
+            ssize_t n = ::recvfrom(fd_, buf, sizeof(buf), 0, nullptr, nullptr);
+            if (n <= 0) {
+                return false;
+            }
+            in.append(buf, static_cast<size_t>(n));
+            if (headerEnd == std::string::npos) {
+                headerEnd = in.find("\r\n\r\n");
+                if (headerEnd == std::string::npos) {
+                    continue;
+                }
+                size_t pos = in.find("Content-Length: ");
+                size_t length = pos < headerEnd ? std::strtoul(in.c_str() + pos + 16, nullptr, 10) : 0;
+                total = headerEnd + 4 + length;
+            }
+            if (in.size() >= total) {
+                return in.find("Connection: close") >= headerEnd;
+            }
+        }
+    }
+
+    // close 会被计入服务端的系统调用，旧连接先 shutdown，留到析构时再关闭
+    void reconnect() {
+        ::shutdown(fd_, SHUT_RDWR);
+        abandoned_.push_back(fd_);
+        connect();
+    }
+
+private:
+    int port_;
+    int fd_;
+    std::vector<int> abandoned_;
+};
+
+enum Mode { kClassic, kReactor, kIoUring };
+
+static void run(Mode mode, int connections, int seconds, size_t ringThreads) {
+    const char *name = mode == kClassic ? "classic" : mode == kReactor ? "classic + reactor" : "io_uring";
+    httplib::Server server;
+    server.Get("/ping", [](const httplib::Request &, httplib::Response &res) {
+        res.set_content("pong", "text/plain");
+    });
+    server.set_keep_alive_max_count(1000000);
+    // 响应头和响应体分两次 send，不关 Nagle 的话每个请求都要等对端的延迟确认（约 40ms），测到的只是这个
+    server.set_tcp_nodelay(true);
+    if (mode == kClassic) {
+        server.new_task_queue = [connections] { return new httplib::ThreadPool(connections); };
+    } else if (mode == kReactor) {
+        server.set_keep_alive_reactor(true);
+    }
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+    if (mode == kIoUring) {
+        server.set_io_uring_threads(ringThreads);
+    }
+#else
+    (void)ringThreads;
+#endif
+    int port = server.bind_to_any_port("127.0.0.1");
+    std::thread listener([&] { server.listen_after_bind(); });
+    server.wait_until_ready();
+
+    std::vector<std::unique_ptr<BenchClient>> clients;
+    for (int i = 0; i < connections; i++) {
+        clients.emplace_back(new BenchClient(port));
+        if (!clients.back()->connect()) {
+            std::fprintf(stderr, "connect failed\n");
+            std::exit(1);
+        }
+    }
+    // 预热：每个连接先走一次，让服务端把连接都接受下来
+    for (auto &c : clients) {
+        if (!c->roundTrip()) {
+            c->reconnect();
+        }
+    }
+
+    std::atomic<bool> stop(false);
+    std::vector<uint64_t> done(connections, 0);
+    std::vector<std::thread> workers;
+    Snapshot before = snapshot(server);
+    auto start = Clock::now();
+    for (int i = 0; i < connections; i++) {
+        workers.emplace_back([&, i] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (clients[i]->roundTrip()) {
+                    done[i]++;
+                } else {
+                    clients[i]->reconnect();
+                }
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    stop = true;
+    for (std::thread &w : workers) {
+        w.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    Snapshot after = snapshot(server);
+
+    uint64_t requests = 0;
+    for (uint64_t n : done) {
+        requests += n;
+    }
+    double per = requests ? 1.0 / static_cast<double>(requests) : 0;
+    uint64_t calls[kKinds];
+    uint64_t total = after.enters - before.enters;
+    for (int k = 0; k < kKinds; k++) {
+        calls[k] = after.calls[k] - before.calls[k];
+        total += calls[k];
+    }
+    std::printf("%-18s %10.0f %8.2f %7.2f %7.2f %7.2f %7.2f %7.2f\n", name, requests / elapsed,
+                total * per, (after.enters - before.enters) * per, calls[kRecv] * per, calls[kSend] * per,
+                calls[kWait] * per, calls[kOther] * per);
+
+    clients.clear();
+    server.stop();
+    listener.join();
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+    if (mode == kIoUring && server.io_uring_stats().requests == 0) {
+        std::printf("%-18s io_uring unavailable on this kernel, the row above is the classic fallback\n", "");
+    }
+#endif
+}
+
+int main(int argc, char **argv) {
+    int connections = argc > 1 ? std::atoi(argv[1]) : 64;
+    int seconds = argc > 2 ? std::atoi(argv[2]) : 3;
+    size_t ringThreads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1;
+
+    std::printf("%d keep-alive connections, %d s per mode; syscalls per request (server side)\n",
+                connections, seconds);
+    std::printf("%-18s %10s %8s %7s %7s %7s %7s %7s\n", "mode", "req/s", "total", "enter", "recv",
+                "send", "wait", "other");
+    run(kClassic, connections, seconds, ringThreads);
+    run(kReactor, connections, seconds, ringThreads);
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+    run(kIoUring, connections, seconds, ringThreads);
+#else
+    std::printf("io_uring           not compiled in (make bench IO_URING=1)\n");
+#endif
+    return 0;
+}
@@ -0,0 +1,110 @@
+// bench/jwt_verify_bench.cpp
+// JWT 校验的吞吐量（每次都 decode + verify，不经过 TokenCache）：
+//   per-call verifier + hs256     每次构造 jwt::verify()，用 jwt::algorithm::hs256 和原始密钥（改动前的做法）
+//   per-call verifier + Hs256Key  每次构造 jwt::verify()，用预先处理好密钥的 Hs256Key
+//   shared verifier + Hs256Key    全部线程共用一个 const verifier（JwtManager 的通用路径）
+//   JwtManager fast path          JwtManager::verifyToken，缓存容量为 0，走 fastVerify
+// 用法: ./bench/jwt_verify_bench [线程数列表=1,2,4] [每种方式的校验次数=40000]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "JwtManager.h"
+#include "Logger.h"
+#include "TokenCache.h"
+
+using Clock = std::chrono::steady_clock;
+
+// 与 JwtManager 中的密钥一致，这样同一个 token 四种方式都能校验通过
+static const std::string kSecret = "your-super-secret-key-change-in-production";
+
+enum Mode { kPerCallHs256, kPerCallKey, kShared, kFastPath, kModes };
+
+static const char *modeName(int mode) {
+    switch (mode) {
+    case kPerCallHs256: return "per-call verifier + hs256";
+    case kPerCallKey:   return "per-call verifier + Hs256Key";
+    case kShared:       return "shared verifier + Hs256Key";
+    default:            return "JwtManager fast path";
+    }
+}
+
+int main(int argc, char **argv) {
+    std::string threadList = argc > 1 ? argv[1] : "1,2,4";
+    int total = argc > 2 ? std::atoi(argv[2]) : 40000;
+
+    Logger::getInstance().setLevel(LogLevel::Error);
+    TokenCache::getInstance().setCapacity(0);
+    JwtManager &jwt = JwtManager::getInstance();
+    const std::string token = jwt.generateToken(1, "bench");
+    const Hs256Key key(kSecret);
+    const auto shared = jwt::verify().allow_algorithm(key).with_issuer("todo-app");
+
+    std::stringstream list(threadList);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        int threads = std::atoi(item.c_str());
+        if (threads <= 0) {
+            continue;
+        }
+        for (int mode = 0; mode < kModes; mode++) {
+            std::vector<std::thread> workers;
+            std::vector<int> failures(threads, 0);
+            auto start = Clock::now();
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&, t] {
+                    for (int i = 0; i < total / threads; i++) {
+                        try {
+                            if (mode == kFastPath) {
+                                failures[t] += jwt.verifyToken(token) ? 0 : 1;
+                                continue;
+                            }
+                            auto decoded = jwt::decode(token);
+                            if (mode == kPerCallHs256) {
+                                jwt::verify().allow_algorithm(jwt::algorithm::hs256{kSecret})
+                                    .with_issuer("todo-app").verify(decoded);
+                            } else if (mode == kPerCallKey) {
+                                jwt::verify().allow_algorithm(key).with_issuer("todo-app").verify(decoded);
+                            } else {
+                                shared.verify(decoded);
+                            }
+                        } catch (const std::exception &e) {
+                            failures[t]++;
+                        }
+                    }
+                });
+            }
+            for (std::thread &w : workers) {
+                w.join();
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            for (int f : failures) {
+                if (f != 0) {
+                    std::fprintf(stderr, "%s: unexpected verification failures: %d\n", modeName(mode), f);
+                    return 1;
+                }
+            }
+            std::printf("threads=%-3d %-30s %10.0f verify/s\n", threads, modeName(mode),
+                        (total / threads) * threads / seconds);
+        }
+    }
+
+    // 篡改过的签名仍然被拒绝
+    std::string bad = token;
+    char &c = bad[bad.rfind('.') + 1];
+    c = c == 'A' ? 'B' : 'A';
+    try {
+        shared.verify(jwt::decode(bad));
+        std::fprintf(stderr, "tampered token accepted by the shared verifier\n");
+        return 1;
+    } catch (const std::exception &e) {
+    }
+    if (jwt.verifyToken(bad)) {
+        std::fprintf(stderr, "tampered token accepted by JwtManager\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+// bench/statement_bench.cpp
+// 对比任务列表查询的三种写法，需要一个可用的 MySQL（连接参数同 TodoApp，读 TODO_DB_* 环境变量）：
+//   sql     每次 session.sql(...) 拼 JOIN 查询（改用 StatementCache 之前的写法）
+//   rebuild 每次 getSchema/getTable/select 重新构造 CRUD 语句
+//   cached  复用 StatementCache 中的语句，只改 bind（现在 Database 的写法）
+// 输出每次调用的平均耗时，以及服务端会话计数器（Mysqlx_*）平均到每次调用的增量。
+// 用法: ./bench/statement_bench [迭代次数=2000] [任务数=50]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+#include <mysqlx/xdevapi.h>
+#include "ConnectionPool.h"
+#include "Database.h"
+#include "SchemaBootstrap.h"
+#include "StatementCache.h"
+
+static PoolConfig loadPoolConfig() {
+    PoolConfig config;
+    if (const char *v = std::getenv("TODO_DB_HOST")) config.host = v;
+    if (const char *v = std::getenv("TODO_DB_PORT")) config.port = std::atoi(v);
+    if (const char *v = std::getenv("TODO_DB_USER")) config.user = v;
+    if (const char *v = std::getenv("TODO_DB_PASSWORD")) config.password = v;
+    if (const char *v = std::getenv("TODO_DB_NAME")) config.database = v;
+    config.minSize = 1;
+    config.maxSize = 1;    // 只有一条连接，计数器的增量就是本程序产生的
+    return config;
+}
+
+// 读取本会话的 X 协议计数器
+static std::map<std::string, long long> sessionCounters(mysqlx::Session &session) {
+    std::map<std::string, long long> counters;
+    mysqlx::SqlResult result = session.sql(
+        "SHOW SESSION STATUS WHERE Variable_name IN ("
+        "'Mysqlx_stmt_execute_sql', 'Mysqlx_crud_find', 'Mysqlx_prepare_prepare', "
+        "'Mysqlx_prepare_execute', 'Mysqlx_bytes_received')").execute();
+    for (mysqlx::Row row : result) {
+        counters[row[0].get<std::string>()] = std::atoll(row[1].get<std::string>().c_str());
+    }
+    return counters;
+}
+
+static size_t drain(mysqlx::RowResult result) {
+    size_t rows = 0;
+    for (mysqlx::Row row : result) {
+        Task task;
+        task.id    = row[0].get<int>();
+        task.title = row[1].get<std::string>();
+        rows++;
+    }
+    return rows;
+}
+
+template <typename Fn>
+static void run(const char *name, mysqlx::Session &session, int iterations, Fn &&fn) {
+    fn();   // 预热：cached 在第二次执行时才会在服务端 prepare
+    fn();
+    std::map<std::string, long long> before = sessionCounters(session);
+    auto start = std::chrono::steady_clock::now();
+    size_t rows = 0;
+    for (int i = 0; i < iterations; i++) {
+        rows += fn();
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::map<std::string, long long> after = sessionCounters(session);
+
+    std::printf("%-8s %9.1f us/call  rows/call=%zu", name, us / iterations, rows / iterations);
+    for (const auto &kv : after) {
+        // 读计数器的 SHOW 本身算一次 Mysqlx_stmt_execute_sql，扣掉
+        long long delta = kv.second - before[kv.first];
+        if (kv.first == "Mysqlx_stmt_execute_sql") delta -= 1;
+        std::printf("  %s=%.2f", kv.first.c_str() + 7, double(delta) / iterations);
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int taskCount = argc > 2 ? std::atoi(argv[2]) : 50;
+
+    PoolConfig config = loadPoolConfig();
+    if (!SchemaBootstrap(config).run() || !ConnectionPool::getInstance().initialize(config)) {
+        std::fprintf(stderr, "无法连接数据库，检查 TODO_DB_* 环境变量\n");
+        return 1;
+    }
+
+    // 准备一个专用用户和 taskCount 条任务
+    Database db;
+    db.connect();
+    const std::string username = "statement_bench";
+    if (db.getIdByName(username) < 0) {
+        db.registerUser(username, "statement_bench@example.invalid", "statement_bench");
+    }
+    int userId = db.getIdByName(username);
+    int existing = static_cast<int>(db.getUserTasks(userId).size());
+    if (existing < taskCount) {
+        std::vector<Task> tasks(taskCount - existing);
+        for (size_t i = 0; i < tasks.size(); i++) {
+            tasks[i].title = "bench task " + std::to_string(existing + i);
+            tasks[i].text = "statement_bench";
+            tasks[i].datetime = "2030-01-01 00:00:00";
+        }
+        db.addTasks(userId, tasks);
+    }
+
+    {
+        ConnectionPool::Lease session = ConnectionPool::getInstance().acquire();
+        StatementCache &stmt = session.connection().statements();
+        const std::string &database = config.database;
+
+        run("sql", *session, iterations, [&] {
+            return drain(session->sql(
+                "SELECT t.id, t.title, t.description, t.completed, "
+                "CAST(t.due_date AS char), CAST(t.created_at AS char) FROM tasks t "
+                "JOIN users u ON t.user_id = u.id "
+                "WHERE u.id = ? "
+                "ORDER BY t.created_at DESC").bind(userId).execute());
+        });
+        run("rebuild", *session, iterations, [&] {
+            mysqlx::Table tasks = session->getSchema(database).getTable("tasks");
+            return drain(tasks.select("id", "title", "description", "completed",
+                                      "CAST(due_date AS CHAR)", "CAST(created_at AS CHAR)")
+                         .where("user_id = :user_id")
+                         .orderBy("created_at DESC", "id DESC")
+                         .bind("user_id", userId).execute());
+        });
+        run("cached", *session, iterations, [&] {
+            return drain(stmt.tasksByUser.bind("user_id", userId).execute());
+        });
+    }
+
+    ConnectionPool::getInstance().shutdown();
+    return 0;
+}
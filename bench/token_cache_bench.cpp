@@ -0,0 +1,76 @@
+// bench/token_cache_bench.cpp
+// JwtManager::verifyToken 的吞吐量：命中 TokenCache 与每次完整校验（缓存容量为 0）对比。
+// threads 个线程反复校验同一批 token（相当于每个浏览器带着自己的 token 重复请求）。
+// 用法: ./bench/token_cache_bench [线程数=1,2,4] [每个线程的校验次数=200000] [token 数=1000]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "JwtManager.h"
+#include "Logger.h"
+#include "TokenCache.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double run(const std::vector<std::string> &tokens, int threads, int iterations) {
+    JwtManager &jwt = JwtManager::getInstance();
+    std::vector<std::thread> workers;
+    std::vector<int> failures(threads, 0);
+    auto start = Clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            size_t next = static_cast<size_t>(t) * 7919;
+            for (int i = 0; i < iterations; i++) {
+                if (!jwt.verifyToken(tokens[next++ % tokens.size()])) {
+                    failures[t]++;
+                }
+            }
+        });
+    }
+    for (std::thread &w : workers) {
+        w.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (int f : failures) {
+        if (f != 0) {
+            std::fprintf(stderr, "unexpected verification failures: %d\n", f);
+            std::exit(1);
+        }
+    }
+    return static_cast<double>(threads) * iterations / seconds;
+}
+
+int main(int argc, char **argv) {
+    std::string threadList = argc > 1 ? argv[1] : "1,2,4";
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 200000;
+    int tokenCount = argc > 3 ? std::atoi(argv[3]) : 1000;
+
+    Logger::getInstance().setLevel(LogLevel::Error);
+    JwtManager &jwt = JwtManager::getInstance();
+    // 容量设为 0 只是不再插入，已缓存的项照样命中，所以完整校验用另一批从未进入缓存的 token
+    std::vector<std::string> tokens, uncached;
+    for (int i = 0; i < tokenCount; i++) {
+        tokens.push_back(jwt.generateToken(i + 1, "user" + std::to_string(i + 1)));
+        uncached.push_back(jwt.generateToken(i + 1, "other" + std::to_string(i + 1)));
+    }
+
+    std::printf("%-8s %16s %16s %8s\n", "threads", "full verify/s", "cache hit/s", "speedup");
+    std::stringstream list(threadList);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        int threads = std::atoi(item.c_str());
+        if (threads <= 0) {
+            continue;
+        }
+        TokenCache::getInstance().setCapacity(0);
+        double full = run(uncached, threads, iterations);
+        TokenCache::getInstance().setCapacity(100000);
+        run(tokens, 1, tokenCount);             // 预热：每个 token 校验一次进入缓存
+        double cached = run(tokens, threads, iterations);
+        std::printf("%-8d %16.0f %16.0f %7.1fx\n", threads, full, cached, cached / full);
+    }
+    return 0;
+}
@@ -50,6 +50,22 @@
 #define CPPHTTPLIB_KEEPALIVE_TIMEOUT_CHECK_INTERVAL_USECOND 10000
 #endif
 
+#ifndef CPPHTTPLIB_KEEPALIVE_PARK_DELAY_USECOND
+#define CPPHTTPLIB_KEEPALIVE_PARK_DELAY_USECOND 10000
+#endif
+
+#ifndef CPPHTTPLIB_IO_URING_ENTRIES
+#define CPPHTTPLIB_IO_URING_ENTRIES 256
+#endif
+
+#ifndef CPPHTTPLIB_IO_URING_MAX_CONNECTIONS
+#define CPPHTTPLIB_IO_URING_MAX_CONNECTIONS 1024
+#endif
+
+#ifndef CPPHTTPLIB_IO_URING_BUFFER_SIZE
+#define CPPHTTPLIB_IO_URING_BUFFER_SIZE 4096
+#endif
+
 #ifndef CPPHTTPLIB_KEEPALIVE_MAX_COUNT
 #define CPPHTTPLIB_KEEPALIVE_MAX_COUNT 100
 #endif
@@ -257,6 +273,15 @@ using socklen_t = int;
 #include <netinet/in.h>
 #ifdef __linux__
 #include <resolv.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+#ifndef __linux__
+#error "CPPHTTPLIB_IO_URING_SUPPORT requires Linux"
+#endif
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
 #endif
 #include <csignal>
 #include <netinet/tcp.h>
@@ -978,6 +1003,13 @@ std::string get_bearer_token_auth(const Request &req);
 
 namespace detail {
 
+#ifdef __linux__
+class KeepAliveReactor;
+#endif
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+class IoUring;
+#endif
+
 class MatcherBase {
 public:
   MatcherBase(std::string pattern) : pattern_(pattern) {}
@@ -1131,6 +1163,32 @@ public:
 
   Server &set_keep_alive_max_count(size_t count);
   Server &set_keep_alive_timeout(time_t sec);
+  // Park idle keep-alive connections in an epoll reactor instead of blocking
+  // a worker thread on them until the next request arrives (Linux only,
+  // ignored elsewhere and by SSLServer).
+  Server &set_keep_alive_reactor(bool on);
+  size_t parked_connections() const;
+  // When the task queue rejects a connection, answer it with "503 Service
+  // Unavailable" and this Retry-After before closing it. 0 (the default)
+  // closes it without a response.
+  Server &set_overload_retry_after(time_t sec);
+
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+  // Serve connections from `threads` io_uring event loops (multishot accept,
+  // registered receive buffers, batched submissions). The rings only do the
+  // network I/O up to a complete request; handlers run on the task queue
+  // (new_task_queue) and write their responses directly. 0 keeps the classic
+  // blocking mode; falls back to it when io_uring or one of the opcodes it
+  // needs is unavailable (probed at startup). Kernels before 5.19 accept one
+  // connection per submission instead of using multishot accept.
+  Server &set_io_uring_threads(size_t threads);
+
+  struct IoUringStats {
+    uint64_t enters = 0;   // io_uring_enter() system calls
+    uint64_t requests = 0; // Requests served by the ring threads
+  };
+  IoUringStats io_uring_stats() const;
+#endif
 
   Server &set_read_timeout(time_t sec, time_t usec = 0);
   template <class Rep, class Period>
@@ -1176,6 +1234,9 @@ protected:
   time_t idle_interval_sec_ = CPPHTTPLIB_IDLE_INTERVAL_SECOND;
   time_t idle_interval_usec_ = CPPHTTPLIB_IDLE_INTERVAL_USECOND;
   size_t payload_max_length_ = CPPHTTPLIB_PAYLOAD_MAX_LENGTH;
+  bool keep_alive_reactor_ = false;
+  std::atomic<size_t> parked_connections_{0};
+  time_t overload_retry_after_sec_ = 0;
 
 private:
   using Handlers =
@@ -1229,6 +1290,19 @@ private:
                          ContentReceiver multipart_receiver) const;
 
   virtual bool process_and_close_socket(socket_t sock);
+#ifdef __linux__
+  bool process_parkable_socket(socket_t sock, size_t keep_alive_count);
+
+  detail::KeepAliveReactor *reactor_ = nullptr;
+#endif
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+  bool listen_io_uring();
+  void run_io_uring_loop(TaskQueue &task_queue);
+
+  size_t io_uring_threads_ = 0;
+  std::atomic<uint64_t> io_uring_enters_{0};
+  std::atomic<uint64_t> io_uring_requests_{0};
+#endif
 
   void output_log(const Request &req, const Response &res) const;
   void output_pre_compression_log(const Request &req,
@@ -3499,6 +3573,501 @@ inline int shutdown_socket(socket_t sock) {
 #endif
 }
 
+// Best-effort "503 Service Unavailable" for a connection that no worker can
+// take, then closes it. Never blocks the caller (the accept or reactor
+// thread): the response goes out with MSG_DONTWAIT, and whatever the client
+// already sent is drained so that the close does not turn into a reset that
+// discards the response.
+inline void reject_overloaded_socket(socket_t sock, time_t retry_after_sec) {
+  std::string res = "HTTP/1.1 503 Service Unavailable\r\nRetry-After: " +
+                    std::to_string(retry_after_sec) +
+                    "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+#ifdef _WIN32
+  send_socket(sock, res.data(), res.size(), 0);
+  shutdown(sock, SD_SEND);
+#else
+  send_socket(sock, res.data(), res.size(), MSG_DONTWAIT);
+  shutdown(sock, SHUT_WR);
+  char buf[4096];
+  for (int i = 0; i < 16; i++) {
+    if (read_socket(sock, buf, sizeof(buf), MSG_DONTWAIT) <= 0) { break; }
+  }
+#endif
+  close_socket(sock);
+}
+
+#ifdef __linux__
+// Holds idle keep-alive sockets in a single epoll instance so that they don't
+// occupy worker threads between requests. A parked socket that becomes
+// readable is handed back through `resume` (normally onto the task queue);
+// sockets that hang up or stay idle past the keep-alive timeout are closed
+// here. Each request gets a fresh SocketStream, so there is never buffered
+// data left in user space when a socket is parked.
+class KeepAliveReactor {
+public:
+  using Resume = std::function<bool(socket_t sock, size_t keep_alive_count)>;
+
+  KeepAliveReactor(Resume resume, std::atomic<size_t> &parked)
+      : resume_(std::move(resume)), parked_(parked) {}
+  ~KeepAliveReactor() { stop(); }
+
+  KeepAliveReactor(const KeepAliveReactor &) = delete;
+  KeepAliveReactor &operator=(const KeepAliveReactor &) = delete;
+
+  bool start();
+  void stop();
+
+  // Returns false if the socket could not be parked; the caller still owns it
+  bool park(socket_t sock, size_t keep_alive_count, time_t timeout_sec);
+
+private:
+  struct Entry {
+    size_t keep_alive_count;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  void run();
+  void close_parked(socket_t sock);
+
+  Resume resume_;
+  std::atomic<size_t> &parked_;
+  int epfd_ = -1;
+  int wakefd_ = -1;
+  std::thread thread_;
+  std::mutex mutex_;
+  bool running_ = false;
+  std::unordered_map<socket_t, Entry> entries_;
+};
+
+inline bool KeepAliveReactor::start() {
+  epfd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epfd_ < 0) { return false; }
+  wakefd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wakefd_ < 0) {
+    close(epfd_);
+    epfd_ = -1;
+    return false;
+  }
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.fd = wakefd_;
+  epoll_ctl(epfd_, EPOLL_CTL_ADD, wakefd_, &ev);
+
+  running_ = true;
+  thread_ = std::thread([this]() { run(); });
+  return true;
+}
+
+inline void KeepAliveReactor::stop() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    running_ = false;
+  }
+  if (thread_.joinable()) {
+    uint64_t one = 1;
+    auto n = ::write(wakefd_, &one, sizeof(one));
+    (void)n;
+    thread_.join();
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  while (!entries_.empty()) {
+    close_parked(entries_.begin()->first);
+  }
+  if (wakefd_ >= 0) {
+    close(wakefd_);
+    wakefd_ = -1;
+  }
+  if (epfd_ >= 0) {
+    close(epfd_);
+    epfd_ = -1;
+  }
+}
+
+inline bool KeepAliveReactor::park(socket_t sock, size_t keep_alive_count,
+                                   time_t timeout_sec) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!running_) { return false; }
+
+  auto &entry = entries_[sock];
+  entry.keep_alive_count = keep_alive_count;
+  entry.deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(timeout_sec);
+
+  epoll_event ev{};
+  ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+  ev.data.fd = sock;
+  if (epoll_ctl(epfd_, EPOLL_CTL_ADD, sock, &ev) < 0) {
+    entries_.erase(sock);
+    return false;
+  }
+  parked_++;
+  return true;
+}
+
+// Requires mutex_
+inline void KeepAliveReactor::close_parked(socket_t sock) {
+  epoll_ctl(epfd_, EPOLL_CTL_DEL, sock, nullptr);
+  entries_.erase(sock);
+  parked_--;
+  shutdown_socket(sock);
+  close_socket(sock);
+}
+
+inline void KeepAliveReactor::run() {
+  using namespace std::chrono;
+
+  const auto sweep_interval = milliseconds{100};
+  auto next_sweep = steady_clock::now() + sweep_interval;
+  epoll_event events[64];
+  std::vector<std::pair<socket_t, size_t>> ready;
+
+  while (true) {
+    auto n = epoll_wait(epfd_, events, 64,
+                        static_cast<int>(sweep_interval.count()));
+    if (n < 0 && errno != EINTR) { break; }
+
+    ready.clear();
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (!running_) { break; }
+
+      for (int i = 0; i < n; i++) {
+        auto sock = events[i].data.fd;
+        if (sock == wakefd_) { continue; }
+        auto it = entries_.find(sock);
+        if (it == entries_.end()) { continue; }
+        if (events[i].events & EPOLLIN) {
+          epoll_ctl(epfd_, EPOLL_CTL_DEL, sock, nullptr);
+          ready.emplace_back(sock, it->second.keep_alive_count);
+          entries_.erase(it);
+          parked_--;
+        } else {
+          close_parked(sock); // Hang-up or error without pending data
+        }
+      }
+
+      auto now = steady_clock::now();
+      if (now >= next_sweep) {
+        for (auto it = entries_.begin(); it != entries_.end();) {
+          auto sock = it->first;
+          auto expired = it->second.deadline <= now;
+          ++it;
+          if (expired) { close_parked(sock); }
+        }
+        next_sweep = now + sweep_interval;
+      }
+    }
+
+    for (const auto &item : ready) {
+      if (!resume_(item.first, item.second)) {
+        shutdown_socket(item.first);
+        close_socket(item.first);
+      }
+    }
+  }
+}
+#endif
+
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+// Minimal io_uring wrapper on top of the raw system calls (no liburing
+// dependency). Used by a single thread; SQEs are queued locally and handed to
+// the kernel in one io_uring_enter() per event loop iteration.
+class IoUring {
+public:
+  IoUring() = default;
+  ~IoUring();
+
+  IoUring(const IoUring &) = delete;
+  IoUring &operator=(const IoUring &) = delete;
+
+  bool init(unsigned entries);
+
+  // Returns nullptr when the submission queue is full; call submit() first
+  io_uring_sqe *get_sqe();
+  // Submits queued SQEs and waits for at least `wait_nr` completions
+  int submit(unsigned wait_nr);
+
+  template <typename T> void for_each_completion(T callback);
+
+  int register_buffers(const struct iovec *iovecs, unsigned count);
+
+  // Whether the running kernel implements every opcode in `ops`
+  // (IORING_REGISTER_PROBE, Linux 5.6+; false on kernels without it)
+  bool supports(std::initializer_list<uint8_t> ops);
+
+  uint64_t enter_count() const { return enters_; }
+
+private:
+  int ring_fd_ = -1;
+  unsigned sq_entries_ = 0;
+
+  void *sq_ptr_ = MAP_FAILED;
+  void *cq_ptr_ = MAP_FAILED;
+  size_t sq_len_ = 0;
+  size_t cq_len_ = 0;
+  io_uring_sqe *sqes_ = nullptr;
+  size_t sqes_len_ = 0;
+
+  unsigned *sq_head_ = nullptr;
+  unsigned *sq_tail_ = nullptr;
+  unsigned *sq_mask_ = nullptr;
+  unsigned *sq_array_ = nullptr;
+  unsigned sq_local_tail_ = 0;
+
+  unsigned *cq_head_ = nullptr;
+  unsigned *cq_tail_ = nullptr;
+  unsigned *cq_mask_ = nullptr;
+  io_uring_cqe *cqes_ = nullptr;
+
+  uint64_t enters_ = 0;
+};
+
+inline IoUring::~IoUring() {
+  if (sqes_) { ::munmap(sqes_, sqes_len_); }
+  if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) { ::munmap(cq_ptr_, cq_len_); }
+  if (sq_ptr_ != MAP_FAILED) { ::munmap(sq_ptr_, sq_len_); }
+  if (ring_fd_ >= 0) { close(ring_fd_); }
+}
+
+inline bool IoUring::init(unsigned entries) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (ring_fd_ < 0) { return false; }
+  sq_entries_ = params.sq_entries;
+
+  sq_len_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_len_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  auto single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) { sq_len_ = cq_len_ = (std::max)(sq_len_, cq_len_); }
+
+  sq_ptr_ = ::mmap(nullptr, sq_len_, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ptr_ == MAP_FAILED) { return false; }
+  if (single_mmap) {
+    cq_ptr_ = sq_ptr_;
+  } else {
+    cq_ptr_ = ::mmap(nullptr, cq_len_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ptr_ == MAP_FAILED) { return false; }
+  }
+  sqes_len_ = params.sq_entries * sizeof(io_uring_sqe);
+  auto sqes = ::mmap(nullptr, sqes_len_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) { return false; }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  auto sq = static_cast<char *>(sq_ptr_);
+  sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  sq_local_tail_ = *sq_tail_;
+
+  auto cq = static_cast<char *>(cq_ptr_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  return true;
+}
+
+inline io_uring_sqe *IoUring::get_sqe() {
+  auto head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (sq_local_tail_ - head >= sq_entries_) { return nullptr; }
+  auto index = sq_local_tail_ & *sq_mask_;
+  sq_array_[index] = index;
+  sq_local_tail_++;
+  auto sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+inline int IoUring::submit(unsigned wait_nr) {
+  auto to_submit = sq_local_tail_ - *sq_tail_;
+  if (to_submit == 0 && wait_nr == 0) { return 0; }
+  __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+  enters_++;
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit,
+                                  wait_nr,
+                                  wait_nr ? IORING_ENTER_GETEVENTS : 0u,
+                                  nullptr, 0));
+}
+
+template <typename T> inline void IoUring::for_each_completion(T callback) {
+  auto head = *cq_head_;
+  auto tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    // Copy out and release the slot first; the callback may queue new SQEs
+    auto cqe = cqes_[head & *cq_mask_];
+    head++;
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    callback(cqe);
+    if (head == tail) { tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE); }
+  }
+}
+
+inline int IoUring::register_buffers(const struct iovec *iovecs,
+                                     unsigned count) {
+  return static_cast<int>(syscall(__NR_io_uring_register, ring_fd_,
+                                  IORING_REGISTER_BUFFERS, iovecs, count));
+}
+
+inline bool IoUring::supports(std::initializer_list<uint8_t> ops) {
+  const unsigned max_ops = 256;
+  std::vector<char> storage(sizeof(io_uring_probe) +
+                            max_ops * sizeof(io_uring_probe_op));
+  auto probe = reinterpret_cast<io_uring_probe *>(storage.data());
+  if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PROBE, probe,
+              max_ops) < 0) {
+    return false;
+  }
+  for (auto op : ops) {
+    if (op > probe->last_op || op >= probe->ops_len ||
+        !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct IoUringConnection {
+  socket_t sock = INVALID_SOCKET;
+  std::string in;  // Received bytes not yet consumed by a request
+  std::string out; // Response bytes being sent
+  size_t out_offset = 0;
+  size_t keep_alive_count = 0;
+  bool reading = false;
+  bool closing = false;
+  bool continue_sent = false;
+  size_t dispatched_len = 0; // Request being handled on a worker thread
+  std::chrono::steady_clock::time_point last_active;
+  std::string remote_addr;
+  int remote_port = 0;
+  std::string local_addr;
+  int local_port = 0;
+};
+
+// Serves one fully received request from memory on a worker thread, so that
+// Server::process_request() runs unchanged. The response is written straight
+// to the socket as it is produced (chunked and streamed responses are not
+// buffered); the ring leaves the connection alone until the worker hands it
+// back.
+class IoUringStream final : public Stream {
+public:
+  IoUringStream(IoUringConnection &conn, size_t size, time_t write_timeout_sec,
+                time_t write_timeout_usec)
+      : conn_(conn), size_(size), write_timeout_sec_(write_timeout_sec),
+        write_timeout_usec_(write_timeout_usec) {}
+
+  bool is_readable() const override { return pos_ < size_; }
+  bool wait_readable() const override { return pos_ < size_; }
+  bool wait_writable() const override {
+    return select_write(conn_.sock, write_timeout_sec_, write_timeout_usec_) >
+               0 &&
+           is_socket_alive(conn_.sock);
+  }
+
+  ssize_t read(char *ptr, size_t size) override {
+    auto n = (std::min)(size, size_ - pos_);
+    memcpy(ptr, conn_.in.data() + pos_, n);
+    pos_ += n;
+    return static_cast<ssize_t>(n);
+  }
+
+  ssize_t write(const char *ptr, size_t size) override {
+    if (!wait_writable()) { return -1; }
+    return send_socket(conn_.sock, ptr, size, CPPHTTPLIB_SEND_FLAGS);
+  }
+
+  void get_remote_ip_and_port(std::string &ip, int &port) const override {
+    ip = conn_.remote_addr;
+    port = conn_.remote_port;
+  }
+
+  void get_local_ip_and_port(std::string &ip, int &port) const override {
+    ip = conn_.local_addr;
+    port = conn_.local_port;
+  }
+
+  socket_t socket() const override { return conn_.sock; }
+  time_t duration() const override { return 0; }
+
+private:
+  IoUringConnection &conn_;
+  size_t size_;
+  size_t pos_ = 0;
+  time_t write_timeout_sec_;
+  time_t write_timeout_usec_;
+};
+
+
+// Finds the end of the first request in `in`. Returns 0 while the request is
+// incomplete and sets `status` when it can't be served from memory.
+inline size_t frame_request(const std::string &in, size_t payload_max_length,
+                            int &status, bool &expect_continue) {
+  status = 0;
+  expect_continue = false;
+  auto header_end = in.find("\r\n\r\n");
+  if (header_end == std::string::npos) {
+    if (in.size() > CPPHTTPLIB_REQUEST_URI_MAX_LENGTH +
+                        CPPHTTPLIB_HEADER_MAX_LENGTH) {
+      status = StatusCode::RequestHeaderFieldsTooLarge_431;
+    }
+    return 0;
+  }
+  header_end += 4;
+
+  size_t content_length = 0;
+  auto has_content_length = false;
+  auto line = in.find("\r\n");
+  while (line != std::string::npos && line + 2 < header_end - 2) {
+    auto begin = line + 2;
+    line = in.find("\r\n", begin);
+    auto field = in.c_str() + begin;
+    if (strncasecmp(field, "Content-Length:", 15) == 0) {
+      // The parsed Request only sees the first value, so a second one (or a
+      // value that isn't a plain number) would frame the body differently
+      // from how it is read; reject it instead of guessing.
+      auto p = field + 15;
+      auto end = in.c_str() + line;
+      while (p < end && (*p == ' ' || *p == '\t')) { p++; }
+      auto digits = p;
+      size_t value = 0;
+      auto overflow = false;
+      while (p < end && *p >= '0' && *p <= '9') {
+        auto digit = static_cast<size_t>(*p - '0');
+        if (value > ((std::numeric_limits<size_t>::max)() - digit) / 10) {
+          overflow = true;
+        }
+        value = value * 10 + digit;
+        p++;
+      }
+      auto has_digits = p != digits;
+      while (p < end && (*p == ' ' || *p == '\t')) { p++; }
+      if (has_content_length || !has_digits || overflow || p != end) {
+        status = StatusCode::BadRequest_400;
+        return 0;
+      }
+      has_content_length = true;
+      content_length = value;
+    } else if (strncasecmp(field, "Transfer-Encoding:", 18) == 0) {
+      status = StatusCode::LengthRequired_411;
+      return 0;
+    } else if (strncasecmp(field, "Expect:", 7) == 0) {
+      expect_continue = true;
+    }
+  }
+  if (content_length > payload_max_length) {
+    status = StatusCode::PayloadTooLarge_413;
+    return 0;
+  }
+  if (in.size() < header_end + content_length) { return 0; }
+  return header_end + content_length;
+}
+#endif
+
 inline std::string escape_abstract_namespace_unix_domain(const std::string &s) {
   if (s.size() > 1 && s[0] == '\0') {
     auto ret = s;
@@ -7472,6 +8041,34 @@ inline Server &Server::set_keep_alive_timeout(time_t sec) {
   return *this;
 }
 
+inline Server &Server::set_keep_alive_reactor(bool on) {
+  keep_alive_reactor_ = on;
+  return *this;
+}
+
+inline size_t Server::parked_connections() const {
+  return parked_connections_.load(std::memory_order_relaxed);
+}
+
+inline Server &Server::set_overload_retry_after(time_t sec) {
+  overload_retry_after_sec_ = sec;
+  return *this;
+}
+
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+inline Server &Server::set_io_uring_threads(size_t threads) {
+  io_uring_threads_ = threads;
+  return *this;
+}
+
+inline Server::IoUringStats Server::io_uring_stats() const {
+  IoUringStats stats;
+  stats.enters = io_uring_enters_.load(std::memory_order_relaxed);
+  stats.requests = io_uring_requests_.load(std::memory_order_relaxed);
+  return stats;
+}
+#endif
+
 inline Server &Server::set_read_timeout(time_t sec, time_t usec) {
   read_timeout_sec_ = sec;
   read_timeout_usec_ = usec;
@@ -7950,9 +8547,41 @@ inline bool Server::listen_internal() {
   is_running_ = true;
   auto se = detail::scope_exit([&]() { is_running_ = false; });
 
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+  if (io_uring_threads_ > 0) {
+    if (listen_io_uring()) { return true; }
+    // io_uring is not available (old kernel, seccomp...): use the classic mode
+    output_error_log(Error::Connection, nullptr);
+  }
+#endif
+
   {
     std::unique_ptr<TaskQueue> task_queue(new_task_queue());
 
+#ifdef __linux__
+    std::unique_ptr<detail::KeepAliveReactor> reactor;
+    if (keep_alive_reactor_) {
+      reactor.reset(new detail::KeepAliveReactor(
+          [this, &task_queue](socket_t sock, size_t keep_alive_count) {
+            if (task_queue->enqueue([this, sock, keep_alive_count]() {
+                  process_parkable_socket(sock, keep_alive_count);
+                })) {
+              return true;
+            }
+            if (overload_retry_after_sec_ <= 0) { return false; }
+            output_error_log(Error::ResourceExhaustion, nullptr);
+            detail::reject_overloaded_socket(sock, overload_retry_after_sec_);
+            return true;
+          },
+          parked_connections_));
+      if (reactor->start()) {
+        reactor_ = reactor.get();
+      } else {
+        reactor.reset();
+      }
+    }
+#endif
+
     while (svr_sock_ != INVALID_SOCKET) {
 #ifndef _WIN32
       if (idle_interval_sec_ > 0 || idle_interval_usec_ > 0) {
@@ -8004,12 +8633,24 @@ inline bool Server::listen_internal() {
       if (!task_queue->enqueue(
               [this, sock]() { process_and_close_socket(sock); })) {
         output_error_log(Error::ResourceExhaustion, nullptr);
-        detail::shutdown_socket(sock);
-        detail::close_socket(sock);
+        if (overload_retry_after_sec_ > 0) {
+          detail::reject_overloaded_socket(sock, overload_retry_after_sec_);
+        } else {
+          detail::shutdown_socket(sock);
+          detail::close_socket(sock);
+        }
       }
     }
 
+#ifdef __linux__
+    // Close parked sockets first; workers that try to park afterwards close
+    // their own sockets. The reactor must outlive the workers.
+    if (reactor) { reactor->stop(); }
+#endif
     task_queue->shutdown();
+#ifdef __linux__
+    reactor_ = nullptr;
+#endif
   }
 
   is_decommissioned = !ret;
@@ -8454,6 +9095,10 @@ Server::process_request(Stream &strm, const std::string &remote_addr,
 inline bool Server::is_valid() const { return true; }
 
 inline bool Server::process_and_close_socket(socket_t sock) {
+#ifdef __linux__
+  if (reactor_) { return process_parkable_socket(sock, keep_alive_max_count_); }
+#endif
+
   std::string remote_addr;
   int remote_port = 0;
   detail::get_remote_ip_and_port(sock, remote_addr, remote_port);
@@ -8477,6 +9122,469 @@ inline bool Server::process_and_close_socket(socket_t sock) {
   return ret;
 }
 
+#ifdef __linux__
+// Same as process_server_socket(), except that when no request arrives within
+// CPPHTTPLIB_KEEPALIVE_PARK_DELAY_USECOND the socket is parked in the reactor
+// and this worker returns to the pool.
+inline bool Server::process_parkable_socket(socket_t sock,
+                                            size_t keep_alive_count) {
+  std::string remote_addr;
+  int remote_port = 0;
+  detail::get_remote_ip_and_port(sock, remote_addr, remote_port);
+
+  std::string local_addr;
+  int local_port = 0;
+  detail::get_local_ip_and_port(sock, local_addr, local_port);
+
+  auto ret = false;
+  auto count = keep_alive_count;
+  while (count > 0 && svr_sock_ != INVALID_SOCKET) {
+    auto val =
+        detail::select_read(sock, 0, CPPHTTPLIB_KEEPALIVE_PARK_DELAY_USECOND);
+    if (val < 0) { break; }
+    if (val == 0) {
+      if (reactor_->park(sock, count, keep_alive_timeout_sec_)) {
+        return true;
+      }
+      break;
+    }
+
+    auto close_connection = count == 1;
+    auto connection_closed = false;
+    detail::SocketStream strm(sock, read_timeout_sec_, read_timeout_usec_,
+                              write_timeout_sec_, write_timeout_usec_);
+    ret = process_request(strm, remote_addr, remote_port, local_addr,
+                          local_port, close_connection, connection_closed,
+                          nullptr);
+    if (!ret || connection_closed) { break; }
+    count--;
+  }
+
+  detail::shutdown_socket(sock);
+  detail::close_socket(sock);
+  return ret;
+}
+#endif
+
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+inline bool Server::listen_io_uring() {
+  {
+    // io_uring_setup() alone is not enough: the event loop needs accept,
+    // recv, send and timeout, which arrived over several kernel releases
+    detail::IoUring probe;
+    if (!probe.init(CPPHTTPLIB_IO_URING_ENTRIES) ||
+        !probe.supports({IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND,
+                         IORING_OP_TIMEOUT, IORING_OP_READ_FIXED,
+                         IORING_OP_READ})) {
+      return false;
+    }
+  }
+
+  // Handlers may block (database, password hashing...), so they run on the
+  // task queue rather than on the ring threads
+  std::unique_ptr<TaskQueue> task_queue(new_task_queue());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < io_uring_threads_; i++) {
+    threads.emplace_back([this, &task_queue]() {
+      run_io_uring_loop(*task_queue);
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  task_queue->shutdown();
+  return true;
+}
+
+// One event loop per thread, each with its own ring and its own multishot
+// accept on the shared listening socket. A connection has at most one
+// receive or send in flight, or is being handled by a worker. Complete
+// requests are passed to process_request() on the task queue through an
+// in-memory stream; the worker writes the response to the socket and hands
+// the connection back through a completion list and an eventfd read by the
+// ring.
+inline void Server::run_io_uring_loop(TaskQueue &task_queue) {
+  using namespace std::chrono;
+
+  enum : uint64_t { op_accept = 1, op_recv, op_send, op_timeout, op_wake };
+  const size_t max_conns = CPPHTTPLIB_IO_URING_MAX_CONNECTIONS;
+  const size_t buf_size = CPPHTTPLIB_IO_URING_BUFFER_SIZE;
+
+  // Everything the kernel may reference is declared before the ring, so
+  // that the ring is torn down first.
+  std::vector<char> buffers(max_conns * buf_size);
+  std::vector<detail::IoUringConnection> conns(max_conns);
+  std::vector<size_t> free_slots;
+  for (size_t i = max_conns; i > 0; i--) {
+    free_slots.push_back(i - 1);
+  }
+  __kernel_timespec tick{};
+  tick.tv_nsec = 100 * 1000 * 1000;
+
+  // Connections handed back by workers
+  struct Handback {
+    std::mutex mutex;
+    std::vector<size_t> slots;
+    int eventfd = -1;
+  } handback;
+  uint64_t wake_value = 0;
+  handback.eventfd = eventfd(0, EFD_CLOEXEC);
+  if (handback.eventfd < 0) {
+    output_error_log(Error::Connection, nullptr);
+    return;
+  }
+  auto close_eventfd = detail::scope_exit([&]() { close(handback.eventfd); });
+
+  detail::IoUring ring;
+  if (!ring.init(CPPHTTPLIB_IO_URING_ENTRIES)) {
+    output_error_log(Error::Connection, nullptr);
+    return;
+  }
+
+  // Registered buffers are pinned once, so receives skip the per-call page
+  // lookup. Without them (e.g. RLIMIT_MEMLOCK) plain IORING_OP_RECV is used.
+  std::vector<struct iovec> iovecs(max_conns);
+  for (size_t i = 0; i < max_conns; i++) {
+    iovecs[i].iov_base = &buffers[i * buf_size];
+    iovecs[i].iov_len = buf_size;
+  }
+  auto fixed_buffers =
+      ring.register_buffers(iovecs.data(), static_cast<unsigned>(max_conns)) ==
+      0;
+
+  auto get_sqe = [&]() {
+    auto sqe = ring.get_sqe();
+    while (!sqe) {
+      ring.submit(0);
+      sqe = ring.get_sqe();
+    }
+    return sqe;
+  };
+
+  size_t in_flight = 0;  // Receives and sends
+  size_t dispatched = 0; // Connections being handled by workers
+  auto accept_armed = false;
+  // Multishot accept needs Linux 5.19 and can't be probed for; older kernels
+  // reject it with -EINVAL, after which every accept is re-armed one by one
+  auto multishot_accept = true;
+  auto stopping = false;
+  uint64_t requests = 0;
+
+  auto arm_accept = [&]() {
+    auto sqe = get_sqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = svr_sock_;
+    if (multishot_accept) { sqe->ioprio = IORING_ACCEPT_MULTISHOT; }
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = op_accept;
+    accept_armed = true;
+  };
+
+  auto arm_timeout = [&]() {
+    auto sqe = get_sqe();
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->addr = reinterpret_cast<uint64_t>(&tick);
+    sqe->len = 1;
+    sqe->user_data = op_timeout;
+  };
+
+  auto arm_wake = [&]() {
+    auto sqe = get_sqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = handback.eventfd;
+    sqe->addr = reinterpret_cast<uint64_t>(&wake_value);
+    sqe->len = sizeof(wake_value);
+    sqe->user_data = op_wake;
+  };
+
+  auto start_recv = [&](size_t slot) {
+    auto &conn = conns[slot];
+    auto sqe = get_sqe();
+    sqe->opcode = fixed_buffers ? IORING_OP_READ_FIXED : IORING_OP_RECV;
+    sqe->fd = conn.sock;
+    sqe->addr = reinterpret_cast<uint64_t>(&buffers[slot * buf_size]);
+    sqe->len = static_cast<uint32_t>(buf_size);
+    if (fixed_buffers) { sqe->buf_index = static_cast<uint16_t>(slot); }
+    sqe->user_data = (slot << 3) | op_recv;
+    conn.reading = true;
+    in_flight++;
+  };
+
+  auto start_send = [&](size_t slot) {
+    auto &conn = conns[slot];
+    auto sqe = get_sqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = conn.sock;
+    sqe->addr = reinterpret_cast<uint64_t>(conn.out.data() + conn.out_offset);
+    sqe->len = static_cast<uint32_t>(conn.out.size() - conn.out_offset);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = (slot << 3) | op_send;
+    conn.reading = false;
+    in_flight++;
+  };
+
+  auto close_conn = [&](size_t slot) {
+    auto &conn = conns[slot];
+    detail::close_socket(conn.sock);
+    conn = detail::IoUringConnection();
+    free_slots.push_back(slot);
+  };
+
+  // Hands the next complete request in the input buffer to a worker;
+  // otherwise answers it from the ring (100 Continue, errors) or goes back to
+  // receiving.
+  auto serve = [&](size_t slot) {
+    auto &conn = conns[slot];
+    auto status = 0;
+    auto expect_continue = false;
+    auto len = detail::frame_request(conn.in, payload_max_length_, status,
+                                     expect_continue);
+    if (status) {
+      // Chunked or oversized requests are not buffered in this mode
+      conn.out = "HTTP/1.1 " + std::to_string(status) + " " +
+                 status_message(status) +
+                 "\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+      conn.closing = true;
+      start_send(slot);
+      return;
+    }
+    if (len == 0) {
+      if (stopping) {
+        close_conn(slot);
+      } else if (expect_continue && !conn.continue_sent) {
+        conn.continue_sent = true;
+        conn.out = "HTTP/1.1 100 Continue\r\n\r\n";
+        start_send(slot);
+      } else {
+        start_recv(slot);
+      }
+      return;
+    }
+
+    conn.continue_sent = false;
+    auto close_connection = conn.keep_alive_count <= 1 || stopping;
+    conn.dispatched_len = len;
+    auto queued = task_queue.enqueue([this, &conn, &handback, slot, len,
+                                      close_connection]() {
+      auto connection_closed = false;
+      detail::IoUringStream strm(conn, len, write_timeout_sec_,
+                                 write_timeout_usec_);
+      auto ret = process_request(strm, conn.remote_addr, conn.remote_port,
+                                 conn.local_addr, conn.local_port,
+                                 close_connection, connection_closed,
+                                 nullptr);
+      conn.closing = !ret || connection_closed || close_connection;
+      {
+        std::lock_guard<std::mutex> guard(handback.mutex);
+        handback.slots.push_back(slot);
+      }
+      uint64_t one = 1;
+      auto n = ::write(handback.eventfd, &one, sizeof(one));
+      (void)n;
+    });
+    if (!queued) {
+      // No worker can take it: refuse like the classic accept loop does
+      output_error_log(Error::ResourceExhaustion, nullptr);
+      conn.dispatched_len = 0;
+      conn.out = "HTTP/1.1 503 Service Unavailable\r\n";
+      if (overload_retry_after_sec_ > 0) {
+        conn.out += "Retry-After: " +
+                    std::to_string(overload_retry_after_sec_) + "\r\n";
+      }
+      conn.out += "Connection: close\r\nContent-Length: 0\r\n\r\n";
+      conn.closing = true;
+      start_send(slot);
+      return;
+    }
+    dispatched++;
+  };
+
+  // A worker finished a request: continue with pipelined input, receive the
+  // next request, or close
+  auto on_handback = [&](size_t slot) {
+    dispatched--;
+    requests++;
+    auto &conn = conns[slot];
+    conn.in.erase(0, conn.dispatched_len);
+    conn.dispatched_len = 0;
+    conn.keep_alive_count--;
+    conn.last_active = steady_clock::now();
+    if (conn.closing) {
+      close_conn(slot);
+      return;
+    }
+    serve(slot);
+  };
+
+  auto on_wake = [&]() {
+    std::vector<size_t> slots;
+    {
+      std::lock_guard<std::mutex> guard(handback.mutex);
+      slots.swap(handback.slots);
+    }
+    for (auto slot : slots) {
+      on_handback(slot);
+    }
+    arm_wake();
+  };
+
+  auto on_accept = [&](const io_uring_cqe &cqe) {
+    if (!(cqe.flags & IORING_CQE_F_MORE)) { accept_armed = false; }
+    if (cqe.res == -EINVAL && multishot_accept) {
+      multishot_accept = false;
+      if (!accept_armed && !stopping) { arm_accept(); }
+      return;
+    }
+    if (cqe.res < 0) { return; } // Re-armed on the next tick
+    socket_t sock = cqe.res;
+    if (free_slots.empty() || stopping) {
+      output_error_log(Error::ResourceExhaustion, nullptr);
+      detail::close_socket(sock);
+      return;
+    }
+    auto slot = free_slots.back();
+    free_slots.pop_back();
+    auto &conn = conns[slot];
+    conn.sock = sock;
+    conn.keep_alive_count = keep_alive_max_count_;
+    conn.last_active = steady_clock::now();
+    // Workers write responses with blocking sends
+    detail::set_socket_opt_time(sock, SOL_SOCKET, SO_SNDTIMEO,
+                                write_timeout_sec_, write_timeout_usec_);
+    detail::get_remote_ip_and_port(sock, conn.remote_addr, conn.remote_port);
+    detail::get_local_ip_and_port(sock, conn.local_addr, conn.local_port);
+    start_recv(slot);
+    if (!accept_armed && !stopping) { arm_accept(); }
+  };
+
+  auto on_recv = [&](size_t slot, int res) {
+    in_flight--;
+    auto &conn = conns[slot];
+    conn.reading = false;
+    if (res == -EAGAIN || res == -EINTR) {
+      start_recv(slot);
+    } else if (res <= 0) {
+      close_conn(slot);
+    } else {
+      conn.in.append(&buffers[slot * buf_size], static_cast<size_t>(res));
+      conn.last_active = steady_clock::now();
+      serve(slot);
+    }
+  };
+
+  auto on_send = [&](size_t slot, int res) {
+    in_flight--;
+    auto &conn = conns[slot];
+    if (res == -EAGAIN || res == -EINTR) {
+      start_send(slot);
+      return;
+    }
+    if (res <= 0) {
+      close_conn(slot);
+      return;
+    }
+    conn.out_offset += static_cast<size_t>(res);
+    if (conn.out_offset < conn.out.size()) {
+      start_send(slot);
+      return;
+    }
+    conn.out.clear();
+    conn.out_offset = 0;
+    if (conn.closing) {
+      close_conn(slot);
+      return;
+    }
+    conn.last_active = steady_clock::now();
+    serve(slot);
+  };
+
+  // Idle connections are shut down; their pending receive then completes
+  // with 0 and the connection is closed.
+  auto on_tick = [&]() {
+    auto now = steady_clock::now();
+    for (auto &conn : conns) {
+      if (conn.sock == INVALID_SOCKET || !conn.reading) { continue; }
+      auto limit = conn.in.empty()
+                       ? duration_cast<microseconds>(
+                             seconds(keep_alive_timeout_sec_))
+                       : duration_cast<microseconds>(
+                             seconds(read_timeout_sec_) +
+                             microseconds(read_timeout_usec_));
+      if (now - conn.last_active > limit) {
+        detail::shutdown_socket(conn.sock);
+      }
+    }
+    if (!accept_armed && !stopping) { arm_accept(); }
+    arm_timeout();
+  };
+
+  arm_accept();
+  arm_timeout();
+  arm_wake();
+
+  uint64_t reported_enters = 0;
+  auto stop_deadline = steady_clock::now();
+  while (true) {
+    if (ring.submit(1) < 0 && errno != EINTR && errno != EAGAIN &&
+        errno != EBUSY) {
+      output_error_log(Error::Connection, nullptr);
+      break;
+    }
+
+    ring.for_each_completion([&](const io_uring_cqe &cqe) {
+      auto op = cqe.user_data & 7;
+      auto slot = static_cast<size_t>(cqe.user_data >> 3);
+      switch (op) {
+      case op_accept: on_accept(cqe); break;
+      case op_recv: on_recv(slot, cqe.res); break;
+      case op_send: on_send(slot, cqe.res); break;
+      case op_timeout: on_tick(); break;
+      case op_wake: on_wake(); break;
+      default: break;
+      }
+    });
+
+    io_uring_enters_ += ring.enter_count() - reported_enters;
+    reported_enters = ring.enter_count();
+    if (requests) {
+      io_uring_requests_ += requests;
+      requests = 0;
+    }
+
+    if (!stopping && svr_sock_ == INVALID_SOCKET) {
+      // Let in-flight responses finish, but stop waiting for new requests
+      stopping = true;
+      stop_deadline = steady_clock::now() + seconds(1);
+      for (auto &conn : conns) {
+        if (conn.sock != INVALID_SOCKET && conn.reading) {
+          detail::shutdown_socket(conn.sock);
+        }
+      }
+    }
+    // Workers still reference their connections, so always wait for them
+    if (stopping && dispatched == 0 &&
+        (in_flight == 0 || steady_clock::now() > stop_deadline)) {
+      break;
+    }
+  }
+
+  // Left the loop on a ring error: workers may still be using connections.
+  // The eventfd may be consumed by the pending ring read, so poll the list.
+  while (dispatched > 0) {
+    {
+      std::lock_guard<std::mutex> guard(handback.mutex);
+      dispatched -= handback.slots.size();
+      handback.slots.clear();
+    }
+    if (dispatched > 0) { std::this_thread::sleep_for(milliseconds(1)); }
+  }
+
+  for (auto &conn : conns) {
+    if (conn.sock != INVALID_SOCKET) { detail::close_socket(conn.sock); }
+  }
+}
+#endif
+
 inline void Server::output_log(const Request &req, const Response &res) const {
   if (logger_) {
     std::lock_guard<std::mutex> guard(logger_mutex_);
@@ -1,115 +1,256 @@
 // httpserver.cpp
 #include <iostream>
 #include <string>
+#include <cstdlib>
+#include <atomic>
 #include "httplib.h"
 #include "nlohmann/json.hpp"
 #include "PasswordHasher.h"
-#include "Database.h"
+#include "Storage.h"
+#include "Client.h"
+#include "SessionRegistry.h"
+#include "ConnectionPool.h"
+#include "SchemaBootstrap.h"
+#include "TaskCache.h"
 #include "JwtManager.h"
+#include "AuthContext.h"
+#include "TokenCache.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "LockFreeTaskQueue.h"
+#include "AdmissionController.h"
 
 #define PORT 8279
 
-using json = nlohmann::json;
+// 单次批量请求最多包含的操作数
+static const size_t kMaxBatchOps = 500;
 
-class Client {
-public:
-    Client() : id(-1), valid(false) {
-        data.connect();
-    }
+using json = nlohmann::json;
 
-    ~Client() {}
+// 从环境变量读取数据库连接池配置，未设置的项使用 PoolConfig 默认值
+static PoolConfig loadPoolConfig() {
+    PoolConfig config;
+    if (const char *v = std::getenv("TODO_DB_HOST")) config.host = v;
+    if (const char *v = std::getenv("TODO_DB_PORT")) config.port = std::atoi(v);
+    if (const char *v = std::getenv("TODO_DB_USER")) config.user = v;
+    if (const char *v = std::getenv("TODO_DB_PASSWORD")) config.password = v;
+    if (const char *v = std::getenv("TODO_DB_NAME")) config.database = v;
+    if (const char *v = std::getenv("TODO_DB_POOL_MIN")) config.minSize = std::strtoul(v, nullptr, 10);
+    if (const char *v = std::getenv("TODO_DB_POOL_MAX")) config.maxSize = std::strtoul(v, nullptr, 10);
+    if (const char *v = std::getenv("TODO_DB_POOL_IDLE_SEC")) config.maxIdleTime = std::chrono::seconds(std::atoi(v));
+    if (const char *v = std::getenv("TODO_DB_POOL_TIMEOUT_MS")) config.acquireTimeout = std::chrono::milliseconds(std::atoi(v));
+    return config;
+}
 
-    int getIdByName(const std::string &username) {
-        return data.getIdByName(username);
-    }
-    bool registerUser(const std::string &username, const std::string &email, const std::string &password) {
-        bool res = data.registerUser(username, email, password);
-        if (res == true) {
-            id = getIdByName(username);
-            valid = true;
-            user = data.getUser(username);
-        }
-        return res;
-    }
+// 从环境变量读取会话表的容量和过期时间
+static SessionLimits loadSessionLimits() {
+    SessionLimits limits;
+    if (const char *v = std::getenv("TODO_SESSION_CAPACITY")) limits.capacity = std::strtoul(v, nullptr, 10);
+    if (const char *v = std::getenv("TODO_SESSION_TTL_SEC")) limits.ttl = std::chrono::seconds(std::atoi(v));
+    return limits;
+}
 
-    bool loginUser(const std::string &username, const std::string &password) {
-        std::cout << "loginUser: " << username << " :" << password << std::endl;
-        bool res = data.loginUser(username, password);
-        if (res == true) {
-            id = getIdByName(username);
-            valid = true;
+// 准入控制：TODO_ADMISSION=off 关闭；TODO_ADMIT_STATIC / TODO_ADMIT_READ / TODO_ADMIT_MUTATION / TODO_ADMIT_AUTH
+// 按 "同时处理数[:排队数[:最长排队毫秒]]" 覆盖对应类别的默认值，例如 TODO_ADMIT_AUTH=2:4:1500
+static void configureAdmission(size_t workers) {
+    AdmissionController &admission = AdmissionController::getInstance();
+    const char *enabled = std::getenv("TODO_ADMISSION");
+    admission.setEnabled(!(enabled && std::string(enabled) == "off"));
+
+    static const struct { AdmissionClass cls; const char *env; } classes[] = {
+        {AdmissionClass::Static, "TODO_ADMIT_STATIC"}, {AdmissionClass::Read, "TODO_ADMIT_READ"},
+        {AdmissionClass::Mutation, "TODO_ADMIT_MUTATION"}, {AdmissionClass::Auth, "TODO_ADMIT_AUTH"},
+    };
+    for (const auto &item : classes) {
+        AdmissionLimits limits = AdmissionController::defaultLimits(item.cls, workers);
+        if (const char *v = std::getenv(item.env)) {
+            char *end = nullptr;
+            limits.maxInFlight = std::strtoul(v, &end, 10);
+            if (*end == ':') limits.maxWaiting = std::strtoul(end + 1, &end, 10);
+            if (*end == ':') limits.maxWait = std::chrono::milliseconds(std::strtoul(end + 1, &end, 10));
         }
-        return res;
+        admission.configure(item.cls, limits);
     }
 
-    bool addTask(int id, const Task &t) {
-        std::cout << "addTask: " << id << std::endl;
-        return data.addTask(id, t);
+    // 覆盖后修改和登录两类可能占满工作线程，读请求会一起排队，只提示不阻止
+    size_t blocking = 0;
+    for (AdmissionClass cls : {AdmissionClass::Mutation, AdmissionClass::Auth}) {
+        AdmissionLimits limits = admission.limits(cls);
+        blocking += limits.maxInFlight + limits.maxWaiting;
     }
-
-    bool delTask(int taskId) {
-        std::cout << "delTask: " << taskId << std::endl;
-        return data.delTask(id);
-    }
-
-    bool updateTaskStatus(int taskId, bool completed) {
-        std::cout << "updateTaskStatus: " << taskId << " :" << completed << std::endl;
-        return data.updateTaskStatus(taskId, completed);
+    if (blocking >= workers) {
+        LOG_WARN("准入控制: 修改和登录合计可占用 " << blocking << " 个工作线程（共 " << workers
+                 << " 个），读请求可能拿不到线程");
     }
+}
 
-    std::vector<Task> getUserTasks(int id) {
-        if (valid == true) {
-            return data.getUserTasks(id);
-        }
-        return std::vector<Task>();
+// 包装 httplib 的线程池：统计排队等待工作线程的连接数、忙碌的工作线程数和排队时间。
+// httplib 每个连接（含 keep-alive 期间的所有请求）占用一个任务。
+class InstrumentedTaskQueue : public httplib::TaskQueue {
+public:
+    InstrumentedTaskQueue(size_t threads, size_t maxQueued)
+        : pool_(threads, maxQueued),
+          queued_(Metrics::getInstance().gauge(
+              "todo_http_queue_depth", "Connections waiting for a worker thread")),
+          busy_(Metrics::getInstance().gauge(
+              "todo_http_busy_workers", "Worker threads currently serving a connection")),
+          rejected_(Metrics::getInstance().counter(
+              "todo_http_queue_rejected_total", "Connections rejected because the queue was full")),
+          wait_(Metrics::getInstance().histogram(
+              "todo_http_queue_wait_seconds", "Time a connection waited for a worker thread")) {
+        Metrics::getInstance().gauge("todo_http_worker_threads", "Size of the HTTP worker pool")
+            .set(static_cast<int64_t>(threads));
     }
 
-    User getUser(const std::string &username) {
-        if (valid == true) {
-            user = data.getUser(username);
-            user.task = getUserTasks(user.id);
+    bool enqueue(std::function<void()> fn) override {
+        queued_.add();
+        auto enqueued = std::chrono::steady_clock::now();
+        bool ok = pool_.enqueue([this, fn, enqueued]() {
+            queued_.sub();
+            wait_.observe(std::chrono::steady_clock::now() - enqueued);
+            AdmissionController::noteQueued(enqueued);
+            ScopedGauge busy(busy_);
+            fn();
+        });
+        if (!ok) {
+            queued_.sub();
+            rejected_.inc();
         }
-        return user;
+        return ok;
     }
 
-    User getUser(int id) {
-        if (valid == true) {
-            user = data.getUser(id);
-            user.task = getUserTasks(id);
-        }
-        return user;
-    }
-    User getUser() {
-        return user;
-    }
+    void shutdown() override { pool_.shutdown(); }
 
 private:
-    int id;
-    bool valid;
-    Database data;
-    User user;
+    httplib::ThreadPool pool_;
+    Gauge &queued_;
+    Gauge &busy_;
+    Counter &rejected_;
+    Histogram &wait_;
 };
 
+// 单个任务的 JSON 表示
+static json taskToJson(const Task &task) {
+    return json{
+        {"id", task.id},
+        {"title", task.title},
+        {"text", task.text},
+        {"completed", task.completed},
+        {"due_date", task.datetime},
+        {"created_at", task.timestamp}
+    };
+}
+
 class TodoAppServer {
 public:
     void start() {
         PasswordHasher::getInstance().initialize();
+        // 存储后端：TODO_STORAGE=memory 时不连接 MySQL，数据只保存在进程内存中
+        const char *backend = std::getenv("TODO_STORAGE");
+        if (!Storage::select(backend ? backend : "mysql")) {
+            return;
+        }
+        if (Storage::backendName() == "mysql") {
+            PoolConfig poolConfig = loadPoolConfig();
+            // 建表、迁移并检查索引，失败时不启动服务
+            if (!SchemaBootstrap(poolConfig).run()) {
+                std::cerr << "数据库表结构检查失败，服务未启动" << std::endl;
+                return;
+            }
+            ConnectionPool::getInstance().initialize(poolConfig);
+        }
+        if (const char *v = std::getenv("TODO_TASK_CACHE_CAPACITY")) {
+            TaskCache::getInstance().setCapacity(std::strtoul(v, nullptr, 10));
+        }
+        if (const char *v = std::getenv("TODO_TOKEN_CACHE_CAPACITY")) {
+            TokenCache::getInstance().setCapacity(std::strtoul(v, nullptr, 10));
+        }
+        if (const char *v = std::getenv("TODO_TASK_CACHE_MAX_BYTES")) {
+            TaskCache::getInstance().setMaxBytes(std::strtoull(v, nullptr, 10));
+        }
+        users.configure(loadSessionLimits());
+
+        registerMetrics();
+        installTaskQueue();
+        configureAdmission(workerThreads);
+        // 静态文件不经过 route()，单独计数
+        server.set_file_request_handler([](const httplib::Request& req, httplib::Response& res) {
+            static Counter &files = Metrics::getInstance().counter(
+                "todo_http_static_files_total", "Static files served from ./www");
+            files.inc();
+        });
+
+        // Prometheus 抓取接口
+        route("GET", "/metrics", [&](const httplib::Request& req, httplib::Response& res) {
+            res.set_content(Metrics::getInstance().render(), "text/plain; version=0.0.4; charset=utf-8");
+        });
+
+        // 健康检查接口，附带连接池指标
+        route("GET", "/api/health", [&](const httplib::Request& req, httplib::Response& res) {
+            PoolStats stats = ConnectionPool::getInstance().stats();
+            TaskCacheStats cacheStats = TaskCache::getInstance().stats();
+            SessionStats sessionStats = users.stats();
+            LoggerStats logStats = Logger::getInstance().stats();
+            uint64_t lookups = cacheStats.hits + cacheStats.misses;
+            json response = {
+                {"status", "success"},
+                {"sessions", sessionStats.size},
+                {"session_cache", {
+                    {"entries", sessionStats.size},
+                    {"evictions", sessionStats.evictions},
+                    {"expirations", sessionStats.expirations},
+                    {"reloads", sessionReloads.load()}
+                }},
+                {"db_pool", {
+                    {"total", stats.total},
+                    {"idle", stats.idle},
+                    {"in_use", stats.inUse},
+                    {"waiting", stats.waiting},
+                    {"acquired", stats.acquired},
+                    {"timeouts", stats.timeouts},
+                    {"created", stats.created},
+                    {"destroyed", stats.destroyed},
+                    {"health_check_failures", stats.healthCheckFailures},
+                    {"wait_time_total_us", stats.waitTimeTotalUs},
+                    {"wait_time_max_us", stats.waitTimeMaxUs}
+                }},
+                {"task_cache", {
+                    {"entries", cacheStats.entries},
+                    {"capacity", cacheStats.capacity},
+                    {"bytes", cacheStats.bytes},
+                    {"max_bytes", cacheStats.maxBytes},
+                    {"hits", cacheStats.hits},
+                    {"misses", cacheStats.misses},
+                    {"hit_rate", lookups ? double(cacheStats.hits) / lookups : 0.0},
+                    {"evictions", cacheStats.evictions},
+                    {"invalidations", cacheStats.invalidations},
+                    {"updates", cacheStats.updates}
+                }},
+                {"logger", {
+                    {"written", logStats.written},
+                    {"dropped", logStats.dropped},
+                    {"truncated", logStats.truncated}
+                }}
+            };
+            res.set_content(response.dump(), "application/json");
+        });
+
         // 用户注册接口
-        server.Post("/api/register", [&](const httplib::Request& req, httplib::Response& res) {
+        route("POST", "/api/register", [&](const httplib::Request& req, httplib::Response& res) {
             try {
                 // 解析JSON请求体
                 auto j = json::parse(req.body);
                 std::string username = j["username"];
                 std::string password = j["password"];
                 std::string email = j["email"];
-                std::cout << "新用户注册" << username << password << email << std::endl;
+                LOG_INFO("新用户注册: " << username << " " << email);
 
                 // 保存到数据库（这里需要你实现）
                 std::shared_ptr<Client> client = std::make_shared<Client>();
                 if (client->registerUser(username, email, password)) {
                     int id = client->getIdByName(username);
-                    std::cout << "新用户注册id: " << id << std::endl;
-                    users[id] = client;
+                    LOG_INFO("新用户注册id: " << id);
+                    users.insert(id, client);
                     // 返回成功响应
                     res.set_content(R"({"status": "success", "message": "User registered"})", "application/json");
                 } else {
@@ -123,7 +264,7 @@ public:
         });
 
         // 用户登录接口
-        server.Post("/api/login", [&](const httplib::Request& req, httplib::Response& res) {
+        route("POST", "/api/login", [&](const httplib::Request& req, httplib::Response& res) {
             try {
                 auto j = json::parse(req.body);
                 std::string username = j["username"];
@@ -131,13 +272,10 @@ public:
 
                 std::shared_ptr<Client> client = std::make_shared<Client>();
                 if (client->loginUser(username, password)) {
-                    User user = client->getUser(username);
-                    if (!users.count(user.id)) {
-                        users[user.id] = client;
-                    }
+                    const User &user = client->getLoginUser();
+                    users.insertIfAbsent(user.id, client);
                     // 生成真实的 JWT token
                     std::string token = JwtManager::getInstance().generateToken(user.id, username);
-                    std::cout << token << std::endl;
 
                     json response;
                     response["status"] = "success";
@@ -160,79 +298,221 @@ public:
             }
         });
 
-        // 获取任务列表
-        server.Get("/api/logout", [&](const httplib::Request& req, httplib::Response& res) {
-            // 验证权限等
+        // 退出登录：注销当前 token（前端用 POST，保留 GET 兼容旧调用）。
+        // 过期时间取 pre-routing 校验后的声明，不重新解码 token
+        httplib::Server::Handler logout = [&](const httplib::Request& req, httplib::Response& res) {
+            auto auth_header = req.headers.find("Authorization");
+            const TokenClaims *claims = AuthContext::current();
+            if (claims && auth_header != req.headers.end() && auth_header->second.size() > 7) {
+                JwtManager::getInstance().revokeToken(auth_header->second.substr(7), *claims);
+            }
             res.set_content(R"({"status": "success", "message": "Logout"})", "application/json");
+        };
+        route("POST", "/api/logout", logout);
+        route("GET", "/api/logout", logout);
+
+        // API: POST /api/tasks 新建任务，返回完整的任务（含数据库生成的 created_at）和新版本号
+        route("POST", "/api/tasks", [&](const httplib::Request& req, httplib::Response& res) {
+            std::shared_ptr<Client> client = sessionFor(req, res);
+            if (!client) {
+                return;
+            }
+            try {
+                auto j = json::parse(req.body);
+                Task task;
+                task.title = j.value("title", "");
+                task.text = j.value("text", "");
+                task.datetime = j.value("datetime", j.value("due_date", ""));
+                if (task.title.empty()) {
+                    res.status = 400;
+                    res.set_content(R"({"status": "error", "message": "Title is required"})", "application/json");
+                    return;
+                }
+
+                int userId = client->getLoginUser().id;
+                int taskId = client->addTask(userId, task);
+                Task created;
+                if (taskId < 0 || !client->getTask(taskId, created)) {
+                    res.status = 500;
+                    res.set_content(R"({"status": "error", "message": "Failed to add task"})", "application/json");
+                    return;
+                }
+                json response = {
+                    {"status", "success"},
+                    {"task", taskToJson(created)},
+                    {"version", client->bumpVersion()}
+                };
+                res.status = 201;
+                res.set_content(response.dump(), "application/json");
+            } catch (const std::exception& e) {
+                res.status = 400;
+                res.set_content(R"({"status": "error", "message": "Invalid request"})", "application/json");
+            }
         });
 
-        // 获取任务列表
-        server.Get("/api/addtask", [&](const httplib::Request& req, httplib::Response& res) {
+        // API: POST /api/tasks/batch 一次提交多个新建/修改/删除操作，在一个事务中执行
+        // 请求: {"ops": [{"op": "create", "title": ..., "text": ..., "datetime": ...},
+        //                {"op": "update", "id": 1, "completed": true},
+        //                {"op": "delete", "id": 2}]}
+        // 响应中 results 与 ops 一一对应；有操作失败时整批不执行，返回 409
+        route("POST", "/api/tasks/batch", [&](const httplib::Request& req, httplib::Response& res) {
+            std::shared_ptr<Client> client = sessionFor(req, res);
+            if (!client) {
+                return;
+            }
+            std::vector<TaskOp> ops;
             try {
-                // 从 Authorization 头获取 token
-                auto auth_header = req.headers.find("Authorization");
-                std::string token = auth_header->second.substr(7);
-                std::cout << token << std::endl;
-
-                int id = JwtManager::getInstance().getUserIdFromToken(token);
-                std::cout << id << std::endl;
-                if (users.count(id)) {
-                    std::cout << "用户已登录" << std::endl;
+                auto j = json::parse(req.body);
+                const json &list = j.at("ops");
+                if (!list.is_array() || list.empty() || list.size() > kMaxBatchOps) {
+                    res.status = 400;
+                    res.set_content(R"({"status": "error", "message": "ops must be a non-empty array of at most )" +
+                                    std::to_string(kMaxBatchOps) + R"( operations"})", "application/json");
+                    return;
+                }
+                for (const json &item : list) {
+                    TaskOp op;
+                    std::string type = item.at("op").get<std::string>();
+                    if (type == "create") {
+                        op.type = TaskOp::Create;
+                        op.task.title = item.value("title", "");
+                        op.task.text = item.value("text", "");
+                        op.task.datetime = item.value("datetime", item.value("due_date", ""));
+                        if (op.task.title.empty()) {
+                            throw std::invalid_argument("title is required");
+                        }
+                    } else if (type == "update") {
+                        op.type = TaskOp::Update;
+                        op.taskId = item.at("id").get<int>();
+                        op.completed = item.at("completed").get<bool>();
+                    } else if (type == "delete") {
+                        op.type = TaskOp::Delete;
+                        op.taskId = item.at("id").get<int>();
+                    } else {
+                        throw std::invalid_argument("unknown op: " + type);
+                    }
+                    ops.push_back(op);
+                }
+            } catch (const std::exception& e) {
+                res.status = 400;
+                json response = {
+                    {"status", "error"},
+                    {"message", std::string("Invalid operation #") + std::to_string(ops.size()) + ": " + e.what()}
+                };
+                res.set_content(response.dump(), "application/json");
+                return;
+            }
+
+            std::vector<TaskOpResult> results;
+            bool committed = client->applyTaskBatch(ops, results);
+            if (results.empty()) {
+                res.status = 500;
+                res.set_content(R"({"status": "error", "message": "Batch failed"})", "application/json");
+                return;
+            }
+
+            json response = {
+                {"status", committed ? "success" : "error"},
+                {"results", json::array()}
+            };
+            for (size_t i = 0; i < ops.size(); i++) {
+                const TaskOpResult &result = results[i];
+                json item = {{"status", result.status}, {"id", result.taskId}};
+                if (committed && ops[i].type != TaskOp::Delete && result.task.id != 0) {
+                    item["task"] = taskToJson(result.task);
                 }
-                User user = users[id]->getUser();
+                response["results"].push_back(item);
+            }
+            if (committed) {
+                // 整批算一次变更
+                response["version"] = client->bumpVersion();
+            } else {
+                res.status = 409;
+                response["message"] = "Batch rolled back";
+                response["version"] = client->version();
+            }
+            res.set_content(response.dump(), "application/json");
+        });
 
+        // API: PATCH /api/tasks/:id 修改完成状态，返回修改后的任务
+        route("PATCH", "/api/tasks/:id", [&](const httplib::Request& req, httplib::Response& res) {
+            std::shared_ptr<Client> client = sessionFor(req, res);
+            if (!client) {
+                return;
+            }
+            try {
+                int taskId = std::stoi(req.path_params.at("id"));
+                auto j = json::parse(req.body);
+                if (!j.contains("completed") || !j["completed"].is_boolean()) {
+                    res.status = 400;
+                    res.set_content(R"({"status": "error", "message": "completed must be a boolean"})", "application/json");
+                    return;
+                }
+                bool changed = client->updateTaskStatus(taskId, j["completed"].get<bool>());
+                Task task;
+                if (!client->getTask(taskId, task)) {
+                    res.status = 404;
+                    res.set_content(R"({"status": "error", "message": "Task not found"})", "application/json");
+                    return;
+                }
+                // 状态本来就相同时不算变更，版本号不变
                 json response = {
                     {"status", "success"},
-                    {"user", {
-                        {"id", user.id},
-                        {"username", user.username},
-                        {"email", user.email},
-                        {"register_date", user.timestamp},
-                        {"task_count", user.task.size()}
-                    }},
-                    {"tasks", json::array()}  // 任务列表将在下面填充
+                    {"task", taskToJson(task)},
+                    {"version", changed ? client->bumpVersion() : client->version()}
                 };
+                res.set_content(response.dump(), "application/json");
+            } catch (const std::exception& e) {
+                res.status = 400;
+                res.set_content(R"({"status": "error", "message": "Invalid request"})", "application/json");
+            }
+        });
 
-                // 填充任务数据
-                try{
-                    for (const auto& task : user.task) {
-                        json task_json = {
-                            {"id", task.id},
-                            {"title", task.title},
-                            {"text", task.text},
-                            {"completed", task.completed},
-                            {"due_date", task.datetime},
-                            {"created_at", task.timestamp}
-                        };
-                        response["tasks"].push_back(task_json);
-                    }
-                } catch (const std::exception& e) {
-                    std::cout << e.what() << std::endl;
+        // API: DELETE /api/tasks/:id
+        route("DELETE", "/api/tasks/:id", [&](const httplib::Request& req, httplib::Response& res) {
+            std::shared_ptr<Client> client = sessionFor(req, res);
+            if (!client) {
+                return;
+            }
+            try {
+                int taskId = std::stoi(req.path_params.at("id"));
+                if (!client->delTask(taskId)) {
+                    res.status = 404;
+                    res.set_content(R"({"status": "error", "message": "Task not found"})", "application/json");
+                    return;
                 }
+                json response = {
+                    {"status", "success"},
+                    {"deleted", taskId},
+                    {"version", client->bumpVersion()}
+                };
                 res.set_content(response.dump(), "application/json");
             } catch (const std::exception& e) {
                 res.status = 400;
-                res.set_content(R"({"status": "error", "message": "Login failed"})", "application/json");
+                res.set_content(R"({"status": "error", "message": "Invalid request"})", "application/json");
             }
         });
 
         // API: GET /api/profile
-        server.Get("/api/profile", [&](const httplib::Request& req, httplib::Response& res) {
+        route("GET", "/api/profile", [&](const httplib::Request& req, httplib::Response& res) {
             try {
-                // 从 Authorization 头获取 token
-                auto auth_header = req.headers.find("Authorization");
-                std::string token = auth_header->second.substr(7);
-                std::cout << token << std::endl;
-
-                int id = JwtManager::getInstance().getUserIdFromToken(token);
-                std::cout << id << std::endl;
-                if (users.count(id)) {
-                    std::cout << "用户已登录" << std::endl;
+                std::shared_ptr<Client> client = sessionFor(req, res);
+                if (!client) {
+                    return;
                 }
-                User user = users[id]->getUser();
+                LOG_DEBUG("用户 " << AuthContext::userId() << " 已登录");
+                // ?stream=1 时边读数据库边输出，不在内存中构造完整的任务列表
+                if (req.get_param_value("stream") == "1") {
+                    streamProfile(client, res);
+                    return;
+                }
+                // 先取版本号再读列表：期间如有变更，前端会再收到一次同样的增量，按任务ID覆盖即可
+                uint64_t version = client->version();
+                User user = client->getUser();
 
                 json response = {
                     {"status", "success"},
+                    {"version", version},
                     {"user", {
                         {"id", user.id},
                         {"username", user.username},
@@ -246,18 +526,10 @@ public:
                 // 填充任务数据
                 try{
                     for (const auto& task : user.task) {
-                        json task_json = {
-                            {"id", task.id},
-                            {"title", task.title},
-                            {"text", task.text},
-                            {"completed", task.completed},
-                            {"due_date", task.datetime},
-                            {"created_at", task.timestamp}
-                        };
-                        response["tasks"].push_back(task_json);
+                        response["tasks"].push_back(taskToJson(task));
                     }
                 } catch (const std::exception& e) {
-                    std::cout << e.what() << std::endl;
+                    LOG_ERROR(e.what());
                 }
                 res.set_content(response.dump(), "application/json");
             } catch (const std::exception& e) {
@@ -266,6 +538,51 @@ public:
             }
         });
 
+        // API: GET /api/tasks?limit=N&after=<cursor> 分页获取任务列表
+        route("GET", "/api/tasks", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                std::shared_ptr<Client> client = sessionFor(req, res);
+                if (!client) {
+                    return;
+                }
+
+                size_t limit = 50;
+                if (req.has_param("limit")) {
+                    limit = std::stoul(req.get_param_value("limit"));
+                    limit = std::max<size_t>(1, std::min<size_t>(limit, 200));
+                }
+                std::string after = req.get_param_value("after");
+
+                uint64_t version = client->version();
+                TaskPage page;
+                PageResult result = client->getUserTasksPage(limit, after, page);
+                if (result == PageResult::InvalidCursor) {
+                    res.status = 400;
+                    res.set_content(R"({"status": "error", "message": "Invalid cursor"})", "application/json");
+                    return;
+                }
+                if (result != PageResult::Ok) {
+                    res.status = 500;
+                    res.set_content(R"({"status": "error", "message": "Failed to load tasks"})", "application/json");
+                    return;
+                }
+
+                json response = {
+                    {"status", "success"},
+                    {"tasks", json::array()},
+                    {"next_cursor", page.nextCursor.empty() ? json(nullptr) : json(page.nextCursor)},
+                    {"version", version}
+                };
+                for (const auto& task : page.tasks) {
+                    response["tasks"].push_back(taskToJson(task));
+                }
+                res.set_content(response.dump(), "application/json");
+            } catch (const std::exception& e) {
+                res.status = 400;
+                res.set_content(R"({"status": "error", "message": "Invalid request"})", "application/json");
+            }
+        });
+
         // 静态文件服务（前端页面）
         server.set_mount_point("/", "./www");
 
@@ -273,69 +590,333 @@ public:
         server.listen("0.0.0.0", PORT);
     }
 
+    // 以 chunked 方式输出 profile：任务按批从数据库读出（写网络时不占用数据库连接），逐个编码成 JSON，
+    // 攒够 kStreamChunkSize 字节就写出一块，单个请求的内存占用只和批大小、块大小有关。
+    // task_count 要在遍历完才知道，所以 user 和 status 放在 tasks 数组之后输出。
+    // 数据库读取都在内容提供函数里，准入名额随它一起保留到响应写完（Response 销毁时归还），
+    // 否则最重的读请求完全不受准入控制。
+    static void streamProfile(std::shared_ptr<Client> client, httplib::Response& res) {
+        const size_t kStreamChunkSize = 16 * 1024;
+        std::shared_ptr<void> permit = AdmissionController::getInstance().detach();
+        res.set_chunked_content_provider("application/json",
+            [client, kStreamChunkSize, permit](size_t offset, httplib::DataSink &sink) {
+                uint64_t version = client->version();
+                std::string buffer = R"({"tasks":[)";
+                buffer.reserve(kStreamChunkSize + 1024);
+                size_t count = 0;
+                bool writable = true;
+
+                bool ok = client->streamUserTasks([&](const Task &task) {
+                    if (count > 0) {
+                        buffer += ',';
+                    }
+                    buffer += taskToJson(task).dump();
+                    count++;
+                    if (buffer.size() >= kStreamChunkSize) {
+                        writable = sink.write(buffer.data(), buffer.size());
+                        buffer.clear();
+                    }
+                    return writable;
+                });
+                if (!writable) {
+                    return false;
+                }
+
+                const User &user = client->getLoginUser();
+                json tail = {
+                    {"status", ok ? "success" : "error"},
+                    {"version", version},
+                    {"user", {
+                        {"id", user.id},
+                        {"username", user.username},
+                        {"email", user.email},
+                        {"register_date", user.timestamp},
+                        {"task_count", count}
+                    }}
+                };
+                std::string tailStr = tail.dump();
+                // 去掉 tail 开头的 '{'，接在 tasks 数组后面
+                buffer += "],";
+                buffer.append(tailStr, 1, std::string::npos);
+                if (!sink.write(buffer.data(), buffer.size())) {
+                    return false;
+                }
+                sink.done();
+                return true;
+            });
+    }
+
+    // 注册路由，并为它创建按状态码分类的请求计数和处理耗时指标。
+    // 指标在注册时创建好，处理请求时只做原子加法，不需要查表。
+    // chunked 响应的耗时只包含处理函数本身，不含后续的流式输出。
+    void route(const std::string &method, const std::string &pattern, httplib::Server::Handler handler) {
+        Metrics &metrics = Metrics::getInstance();
+        MetricLabels labels = {{"method", method}, {"route", pattern}};
+        Histogram *latency = &metrics.histogram(
+            "todo_http_request_duration_seconds", "HTTP handler latency by route", labels);
+        std::vector<Counter*> responses;
+        for (const char *code : {"1xx", "2xx", "3xx", "4xx", "5xx"}) {
+            MetricLabels withCode = labels;
+            withCode.push_back({"code", code});
+            responses.push_back(&metrics.counter(
+                "todo_http_requests_total", "HTTP requests by route and status class", withCode));
+        }
+
+        httplib::Server::Handler wrapped = [handler, latency, responses](const httplib::Request& req, httplib::Response& res) {
+            {
+                ScopedTimer timer(*latency);
+                handler(req, res);
+            }
+            // 处理函数没设置状态码时 httplib 按 200 返回
+            int status = res.status <= 0 ? 200 : res.status;
+            size_t index = static_cast<size_t>(std::min(std::max(status / 100, 1), 5) - 1);
+            responses[index]->inc();
+        };
+        if (method == "GET") {
+            server.Get(pattern, wrapped);
+        } else if (method == "POST") {
+            server.Post(pattern, wrapped);
+        } else if (method == "PATCH") {
+            server.Patch(pattern, wrapped);
+        } else if (method == "DELETE") {
+            server.Delete(pattern, wrapped);
+        }
+    }
+
+    // 已有的统计结构通过回调暴露，抓取 /metrics 时读取
+    void registerMetrics() {
+        Metrics &metrics = Metrics::getInstance();
+
+        metrics.gaugeCallback("todo_http_parked_connections", "Idle keep-alive connections parked in the epoll reactor", {},
+                              [this] { return static_cast<double>(server.parked_connections()); });
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+        metrics.counterCallback("todo_http_io_uring_enters_total", "io_uring_enter system calls made by the ring threads", {},
+                                [this] { return static_cast<double>(server.io_uring_stats().enters); });
+        metrics.counterCallback("todo_http_io_uring_requests_total", "Requests served by the io_uring event loops", {},
+                                [this] { return static_cast<double>(server.io_uring_stats().requests); });
+#endif
+        metrics.gaugeCallback("todo_token_cache_entries", "Verified tokens held in the token cache", {},
+                              [] { return static_cast<double>(TokenCache::getInstance().stats().entries); });
+        metrics.gaugeCallback("todo_token_cache_revoked", "Revoked tokens that have not expired yet", {},
+                              [] { return static_cast<double>(TokenCache::getInstance().stats().revoked); });
+        metrics.counterCallback("todo_token_cache_hits_total", "Token verifications answered from the cache", {},
+                                [] { return static_cast<double>(TokenCache::getInstance().stats().hits); });
+        metrics.counterCallback("todo_token_cache_misses_total", "Token verifications that needed a full decode", {},
+                                [] { return static_cast<double>(TokenCache::getInstance().stats().misses); });
+        metrics.counterCallback("todo_token_cache_revoked_rejects_total", "Requests rejected because the token was revoked", {},
+                                [] { return static_cast<double>(TokenCache::getInstance().stats().revokedRejects); });
+        metrics.gaugeCallback("todo_sessions", "Sessions held in the registry", {},
+                              [this] { return static_cast<double>(users.stats().size); });
+        metrics.counterCallback("todo_session_evictions_total", "Sessions evicted by capacity", {},
+                                [this] { return static_cast<double>(users.stats().evictions); });
+        metrics.counterCallback("todo_session_expirations_total", "Sessions removed after the idle TTL", {},
+                                [this] { return static_cast<double>(users.stats().expirations); });
+        metrics.counterCallback("todo_session_reloads_total", "Evicted sessions rebuilt from a valid token", {},
+                                [this] { return static_cast<double>(sessionReloads.load()); });
+
+        struct PoolMetric { const char *name; const char *help; bool counter; double (*read)(const PoolStats &); };
+        static const PoolMetric poolMetrics[] = {
+            {"todo_db_pool_connections", "Open database connections", false,
+             [](const PoolStats &s) { return double(s.total); }},
+            {"todo_db_pool_idle", "Idle database connections", false,
+             [](const PoolStats &s) { return double(s.idle); }},
+            {"todo_db_pool_in_use", "Database connections on loan", false,
+             [](const PoolStats &s) { return double(s.inUse); }},
+            {"todo_db_pool_waiting", "Threads waiting for a database connection", false,
+             [](const PoolStats &s) { return double(s.waiting); }},
+            {"todo_db_pool_acquired_total", "Database connections handed out", true,
+             [](const PoolStats &s) { return double(s.acquired); }},
+            {"todo_db_pool_timeouts_total", "Connection requests that timed out", true,
+             [](const PoolStats &s) { return double(s.timeouts); }},
+            {"todo_db_pool_created_total", "Database connections opened", true,
+             [](const PoolStats &s) { return double(s.created); }},
+            {"todo_db_pool_destroyed_total", "Database connections closed", true,
+             [](const PoolStats &s) { return double(s.destroyed); }},
+            {"todo_db_pool_health_check_failures_total", "Borrowed connections that failed the ping", true,
+             [](const PoolStats &s) { return double(s.healthCheckFailures); }},
+        };
+        for (const PoolMetric &m : poolMetrics) {
+            double (*read)(const PoolStats &) = m.read;
+            auto fn = [read] { return read(ConnectionPool::getInstance().stats()); };
+            if (m.counter) {
+                metrics.counterCallback(m.name, m.help, {}, fn);
+            } else {
+                metrics.gaugeCallback(m.name, m.help, {}, fn);
+            }
+        }
+
+        metrics.gaugeCallback("todo_task_cache_entries", "Users with a cached task list", {},
+                              [] { return static_cast<double>(TaskCache::getInstance().stats().entries); });
+        metrics.gaugeCallback("todo_task_cache_bytes", "Estimated memory held by the task cache", {},
+                              [] { return static_cast<double>(TaskCache::getInstance().stats().bytes); });
+        metrics.counterCallback("todo_task_cache_hits_total", "Task cache hits", {},
+                                [] { return static_cast<double>(TaskCache::getInstance().stats().hits); });
+        metrics.counterCallback("todo_task_cache_misses_total", "Task cache misses", {},
+                                [] { return static_cast<double>(TaskCache::getInstance().stats().misses); });
+        metrics.counterCallback("todo_task_cache_evictions_total", "Task cache evictions", {},
+                                [] { return static_cast<double>(TaskCache::getInstance().stats().evictions); });
+
+        metrics.counterCallback("todo_log_dropped_total", "Log records dropped because a ring buffer was full", {},
+                                [] { return static_cast<double>(Logger::getInstance().stats().dropped); });
+    }
+
+    // 取用户的会话。会话因容量/过期被淘汰时，token 仍然有效，
+    // 按 token 中的用户ID重新加载用户信息并放回会话表，对前端透明。
+    // 用户已被删除时返回空指针，调用方按会话过期处理。
+    std::shared_ptr<Client> findSession(int id) {
+        std::shared_ptr<Client> client = users.lookup(id);
+        if (client) {
+            return client;
+        }
+        client = std::make_shared<Client>();
+        if (!client->restore(id)) {
+            return nullptr;
+        }
+        sessionReloads++;
+        return users.insertIfAbsent(id, client);
+    }
+
+    // 按 pre-routing 校验 token 时记下的用户ID取会话，
+    // 取不到时写好 401 响应并返回空指针
+    std::shared_ptr<Client> sessionFor(const httplib::Request& req, httplib::Response& res) {
+        std::shared_ptr<Client> client;
+        int id = AuthContext::userId();
+        if (id > 0) {
+            client = findSession(id);
+        }
+        if (!client) {
+            res.status = 401;
+            res.set_content(R"({"status": "error", "message": "Session expired, please login again"})", "application/json");
+        }
+        return client;
+    }
+
     // 添加 server 的访问方法
     httplib::Server& getServer() { return server; }
     const httplib::Server& getServer() const { return server; }
 private:
+    // HTTP 执行器：默认使用无锁队列执行器，TODO_HTTP_EXECUTOR=threadpool 时使用 httplib 自带的线程池。
+    // TODO_HTTP_THREADS 设置工作线程数，TODO_HTTP_QUEUE_CAPACITY 设置等待连接数上限（两种执行器都生效，
+    // httplib 线程池默认的 max_queued_requests 为 0，即不限）。
+    void installTaskQueue() {
+        size_t threads = CPPHTTPLIB_THREAD_POOL_COUNT;
+        size_t capacity = 4096;
+        if (const char *v = std::getenv("TODO_HTTP_THREADS")) threads = std::strtoul(v, nullptr, 10);
+        if (const char *v = std::getenv("TODO_HTTP_QUEUE_CAPACITY")) capacity = std::strtoul(v, nullptr, 10);
+        workerThreads = threads;
+        // 执行器队列满时回 503 和 Retry-After 再关闭连接，而不是直接断开
+        server.set_overload_retry_after(1);
+        // 空闲的 keep-alive 连接交给 epoll 等待下一个请求，不占工作线程；TODO_HTTP_KEEPALIVE_REACTOR=off 关闭
+        const char *reactor = std::getenv("TODO_HTTP_KEEPALIVE_REACTOR");
+        server.set_keep_alive_reactor(!(reactor && std::string(reactor) == "off"));
+        // TODO_HTTP_IO_URING=<线程数> 改用 io_uring 事件循环（需要 make IO_URING=1 编译），
+        // 这些线程只收请求，处理函数仍在下面的执行器上运行
+        if (const char *v = std::getenv("TODO_HTTP_IO_URING")) {
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+            server.set_io_uring_threads(std::strtoul(v, nullptr, 10));
+#else
+            std::cerr << "未启用 io_uring 支持（make IO_URING=1），忽略 TODO_HTTP_IO_URING" << std::endl;
+#endif
+        }
+        const char *executor = std::getenv("TODO_HTTP_EXECUTOR");
+        if (executor && std::string(executor) == "threadpool") {
+            server.new_task_queue = [threads, capacity] { return new InstrumentedTaskQueue(threads, capacity); };
+        } else {
+            server.new_task_queue = [threads, capacity] { return new LockFreeTaskQueue(threads, capacity); };
+        }
+    }
+
     httplib::Server server;
-    std::map<int, std::shared_ptr<Client>> users;
+    SessionRegistry users;
+    std::atomic<uint64_t> sessionReloads{0};
+    size_t workerThreads = CPPHTTPLIB_THREAD_POOL_COUNT;
 };
 
 int main() {
+    // 日志级别：TODO_LOG_LEVEL=debug|info|warn|error|off，默认 info
+    Logger &logger = Logger::getInstance();
+    if (const char *v = std::getenv("TODO_LOG_LEVEL")) {
+        LogLevel level;
+        if (Logger::parseLevel(v, level)) {
+            logger.setLevel(level);
+        } else {
+            std::cerr << "未知的日志级别: " << v << std::endl;
+        }
+    }
+    logger.start();
+
     TodoAppServer app;
 
     // 在服务器设置中添加中间件
     app.getServer().set_pre_routing_handler([&](const httplib::Request& req, httplib::Response& res) {
+        // 同一工作线程上一个请求的认证信息不能带到这个请求
+        AuthContext::reset();
+
         // 设置 CORS 头
         res.set_header("Access-Control-Allow-Origin", "*");
-        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
+        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, PATCH, DELETE, OPTIONS");
         res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
 
+        static Counter &preflight = Metrics::getInstance().counter(
+            "todo_http_prerouting_handled_total", "Requests answered by the pre-routing handler", {{"reason", "preflight"}});
+        static Counter &unauthorized = Metrics::getInstance().counter(
+            "todo_http_prerouting_handled_total", "Requests answered by the pre-routing handler", {{"reason", "unauthorized"}});
+
         // 处理预检请求
         if (req.method == "OPTIONS") {
+            preflight.inc();
             res.status = 200;
             return httplib::Server::HandlerResponse::Handled;
         }
 
         // 调试信息
-        std::cout << "Request: " << req.method << " " << req.path << std::endl;
+        LOG_DEBUG("Request: " << req.method << " " << req.path);
+
+        // 按类别领取处理名额，超载时直接返回 503，不再验证 token
+        if (!AdmissionController::getInstance().enter(req, res)) {
+            return httplib::Server::HandlerResponse::Handled;
+        }
 
         // 允许所有静态文件访问（不需要认证）
-        if (req.path.find("/api/") == std::string::npos) {
-            std::cout << "Allowing static file: " << req.path << std::endl;
+        if (req.path.find("/api/") == std::string::npos && req.path != "/metrics") {
             return httplib::Server::HandlerResponse::Unhandled;
         }
 
         // 允许特定的公开API（不需要认证）
-        if (req.path == "/api/login" || req.path == "/api/register" || req.path == "/api/health") {
-            std::cout << "Allowing public API: " << req.path << std::endl;
+        if (req.path == "/api/login" || req.path == "/api/register" || req.path == "/api/health" ||
+            req.path == "/metrics") {
             return httplib::Server::HandlerResponse::Unhandled;
         }
 
         // 只有需要认证的API请求才检查token
-        std::cout << "Requiring auth for API: " << req.path << std::endl;
-
         // 检查 Authorization 头
         auto auth_header = req.headers.find("Authorization");
-        if (auth_header == req.headers.end()) {
-            std::cout << "Missing Authorization header" << std::endl;
+        if (auth_header == req.headers.end() || auth_header->second.size() <= 7) {
+            LOG_DEBUG("Missing Authorization header: " << req.path);
             res.status = 401;
             res.set_content(R"({"status": "error", "message": "Authorization header required"})", "application/json");
+            unauthorized.inc();
             return httplib::Server::HandlerResponse::Handled;
         }
 
-        std::string token = auth_header->second.substr(7);
-        if (!JwtManager::getInstance().verifyToken(token)) {
-            std::cout << "Token verification failed" << std::endl;
+        // 只解码校验一次，声明放进 AuthContext 供处理函数使用
+        TokenClaims claims;
+        if (!JwtManager::getInstance().verifyToken(auth_header->second.substr(7), claims)) {
             res.status = 401;
             res.set_content(R"({"status": "error", "message": "Invalid or expired token"})", "application/json");
+            unauthorized.inc();
             return httplib::Server::HandlerResponse::Handled;
         }
-
-        std::cout << "Token verification successful" << std::endl;
+        AuthContext::set(claims);
         return httplib::Server::HandlerResponse::Unhandled;
     });
 
+    // 响应头写出前归还准入名额（包括 pre-routing 直接返回的 401；流式响应的名额已转交给内容提供函数）
+    app.getServer().set_post_routing_handler([](const httplib::Request& req, httplib::Response& res) {
+        AdmissionController::getInstance().leave();
+    });
+
     app.start();
+    logger.shutdown();
     return 0;
 }
@@ -3,11 +3,20 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+// SSSE3/AVX2 encode and decode, selected at runtime, used for alphabets of the form A-Z a-z 0-9 plus two symbols.
+// Define JWT_DISABLE_BASE64_SIMD to always use the scalar table-driven code.
+#if !defined(JWT_DISABLE_BASE64_SIMD) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define JWT_BASE64_SIMD
+#include <immintrin.h>
+#endif
+
 #ifdef __has_cpp_attribute
 #if __has_cpp_attribute(fallthrough)
 #define JWT_FALLTHROUGH [[fallthrough]]
@@ -95,6 +104,44 @@ namespace jwt {
 
 			return static_cast<uint32_t>(std::distance(alphabet.cbegin(), itr));
 		}
+
+		/**
+		 * \brief Precomputed lookup for an alphabet
+		 *
+		 * Maps every byte to its sextet (or -1 when it is not part of the alphabet) so decoding costs one load per
+		 * character instead of a search through the alphabet.
+		 */
+		struct lookup_table {
+			std::array<char, 64> symbols{};
+			std::array<int8_t, 256> sextets{};
+			/// The alphabet is A-Z, a-z, 0-9 followed by two other distinct symbols, which the SIMD paths handle
+			bool standard = false;
+
+			explicit lookup_table(const std::array<char, 64>& alphabet) : symbols(alphabet) {
+				sextets.fill(-1);
+				// Walk backwards so the first occurrence wins for alphabets with duplicates, as in index()
+				for (size_t i = alphabet.size(); i-- > 0;)
+					sextets[static_cast<unsigned char>(alphabet[i])] = static_cast<int8_t>(i);
+
+				standard = true;
+				for (size_t i = 0; i < 62; i++) {
+					char expected = i < 26   ? static_cast<char>('A' + i)
+									: i < 52 ? static_cast<char>('a' + (i - 26))
+											 : static_cast<char>('0' + (i - 52));
+					if (alphabet[i] != expected) standard = false;
+				}
+				if (sextets[static_cast<unsigned char>(alphabet[62])] != 62 ||
+					sextets[static_cast<unsigned char>(alphabet[63])] != 63)
+					standard = false;
+			}
+
+			uint32_t index(char symbol) const {
+				const int8_t sextet = sextets[static_cast<unsigned char>(symbol)];
+				if (sextet < 0) { throw std::runtime_error("Invalid input: not within alphabet"); }
+
+				return static_cast<uint32_t>(sextet);
+			}
+		};
 	} // namespace alphabet
 
 	/**
@@ -116,95 +163,312 @@ namespace jwt {
 				}
 			};
 
-			inline padding count_padding(const std::string& base, const std::vector<std::string>& fills) {
-				for (const auto& fill : fills) {
-					if (base.size() < fill.size()) continue;
-					// Does the end of the input exactly match the fill pattern?
-					if (base.substr(base.size() - fill.size()) == fill) {
-						return padding{1, fill.length()} +
-							   count_padding(base.substr(0, base.size() - fill.size()), fills);
+			inline padding count_padding(const std::string& base, const std::string* fills, size_t fill_count) {
+				padding result;
+				size_t end = base.size();
+				for (size_t i = 0; i < fill_count;) {
+					const std::string& fill = fills[i];
+					// Does the end of the (remaining) input exactly match the fill pattern?
+					if (!fill.empty() && end >= fill.size() &&
+						base.compare(end - fill.size(), fill.size(), fill) == 0) {
+						result = result + padding{1, fill.size()};
+						end -= fill.size();
+						i = 0;
+					} else {
+						i++;
 					}
 				}
 
-				return {};
+				return result;
 			}
 
-			inline std::string encode(const std::string& bin, const std::array<char, 64>& alphabet,
-									  const std::string& fill) {
-				size_t size = bin.size();
-				std::string res;
+			inline padding count_padding(const std::string& base, const std::vector<std::string>& fills) {
+				return count_padding(base, fills.data(), fills.size());
+			}
+
+#ifdef JWT_BASE64_SIMD
+			/**
+			 * \brief Vectorised cores for the common alphabets
+			 *
+			 * Each function processes whole blocks only and returns how much of the input it consumed; the caller
+			 * finishes the rest with the scalar code. Decoders stop at the first block holding a byte outside the
+			 * alphabet so the scalar code reports the error.
+			 */
+			namespace simd {
+				__attribute__((target("ssse3"))) inline __m128i encode_lookup(__m128i indices, __m128i shift) {
+					// 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+					__m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+					const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+					result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+					return _mm_add_epi8(_mm_shuffle_epi8(shift, result), indices);
+				}
 
-				// clear incomplete bytes
-				size_t fast_size = size - size % 3;
-				for (size_t i = 0; i < fast_size;) {
-					uint32_t octet_a = static_cast<unsigned char>(bin[i++]);
-					uint32_t octet_b = static_cast<unsigned char>(bin[i++]);
-					uint32_t octet_c = static_cast<unsigned char>(bin[i++]);
+				inline __m128i encode_shift(char s62, char s63) {
+					return _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+										 '0' - 52, '0' - 52, '0' - 52, static_cast<char>(s62 - 62),
+										 static_cast<char>(s63 - 63), 'A', 0, 0);
+				}
 
-					uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08) + octet_c;
+				// 12 input bytes -> 16 characters; reads 16 bytes per block
+				__attribute__((target("ssse3"))) inline size_t encode_ssse3(const char* in, size_t len, char* out,
+																			char s62, char s63) {
+					const __m128i shift = encode_shift(s62, s63);
+					size_t i = 0;
+					for (; i + 16 <= len; i += 12, out += 16) {
+						__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+						v = _mm_shuffle_epi8(v, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+						const __m128i hi = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)),
+														   _mm_set1_epi32(0x04000040));
+						const __m128i lo = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)),
+														   _mm_set1_epi32(0x01000010));
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(out), encode_lookup(_mm_or_si128(hi, lo), shift));
+					}
+					return i;
+				}
 
-					res += alphabet[(triple >> 3 * 6) & 0x3F];
-					res += alphabet[(triple >> 2 * 6) & 0x3F];
-					res += alphabet[(triple >> 1 * 6) & 0x3F];
-					res += alphabet[(triple >> 0 * 6) & 0x3F];
+				// 24 input bytes -> 32 characters; reads 28 bytes per block
+				__attribute__((target("avx2"))) inline size_t encode_avx2(const char* in, size_t len, char* out,
+																		  char s62, char s63) {
+					const __m256i shift = _mm256_broadcastsi128_si256(encode_shift(s62, s63));
+					const __m256i spread = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2,
+															1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+					size_t i = 0;
+					for (; i + 28 <= len; i += 24, out += 32) {
+						__m256i v = _mm256_inserti128_si256(
+							_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))),
+							_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12)), 1);
+						v = _mm256_shuffle_epi8(v, spread);
+						const __m256i hi = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)),
+															  _mm256_set1_epi32(0x04000040));
+						const __m256i lo = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)),
+															  _mm256_set1_epi32(0x01000010));
+						const __m256i indices = _mm256_or_si256(hi, lo);
+
+						__m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+						const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+						result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+						result = _mm256_add_epi8(_mm256_shuffle_epi8(shift, result), indices);
+						_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), result);
+					}
+					return i;
 				}
 
-				if (fast_size == size) return res;
+				/// 0xFF in every byte of c within [first, last]; bytes >= 0x80 compare as negative and never match
+				inline __m128i in_range(__m128i c, char first, char last) {
+					return _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8(static_cast<char>(first - 1))),
+										 _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(last + 1)), c));
+				}
 
-				size_t mod = size % 3;
+				__attribute__((target("avx2"))) inline __m256i in_range(__m256i c, char first, char last) {
+					return _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8(static_cast<char>(first - 1))),
+											_mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(last + 1)), c));
+				}
 
-				uint32_t octet_a = fast_size < size ? static_cast<unsigned char>(bin[fast_size++]) : 0;
-				uint32_t octet_b = fast_size < size ? static_cast<unsigned char>(bin[fast_size++]) : 0;
-				uint32_t octet_c = fast_size < size ? static_cast<unsigned char>(bin[fast_size++]) : 0;
+				// 16 characters -> 12 bytes
+				__attribute__((target("ssse3"))) inline size_t decode_ssse3(const char* in, size_t len,
+																			unsigned char* out, char s62, char s63) {
+					const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+					size_t i = 0;
+					for (; i + 16 <= len; i += 16, out += 12) {
+						const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+						const __m128i upper = in_range(c, 'A', 'Z');
+						const __m128i lower = in_range(c, 'a', 'z');
+						const __m128i digit = in_range(c, '0', '9');
+						const __m128i sym62 = _mm_cmpeq_epi8(c, _mm_set1_epi8(s62));
+						const __m128i sym63 = _mm_cmpeq_epi8(c, _mm_set1_epi8(s63));
+						const __m128i valid =
+							_mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, sym62)), sym63);
+						if (_mm_movemask_epi8(valid) != 0xFFFF) break;
+
+						__m128i offset = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+						offset = _mm_or_si128(offset, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+						offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+						offset = _mm_or_si128(offset, _mm_and_si128(sym62, _mm_set1_epi8(static_cast<char>(62 - s62))));
+						offset = _mm_or_si128(offset, _mm_and_si128(sym63, _mm_set1_epi8(static_cast<char>(63 - s63))));
+						const __m128i sextets = _mm_add_epi8(c, offset);
+
+						// aaaaaabb bbbbcccc ccdddddd packed big-endian into each 32-bit lane, then gathered
+						const __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+						const __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+						alignas(16) unsigned char block[16];
+						_mm_store_si128(reinterpret_cast<__m128i*>(block), _mm_shuffle_epi8(words, pack));
+						std::memcpy(out, block, 12);
+					}
+					return i;
+				}
 
-				uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08) + octet_c;
+				// 32 characters -> 24 bytes
+				__attribute__((target("avx2"))) inline size_t decode_avx2(const char* in, size_t len,
+																		  unsigned char* out, char s62, char s63) {
+					const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1,
+														  0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+					size_t i = 0;
+					for (; i + 32 <= len; i += 32, out += 24) {
+						const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+						const __m256i upper = in_range(c, 'A', 'Z');
+						const __m256i lower = in_range(c, 'a', 'z');
+						const __m256i digit = in_range(c, '0', '9');
+						const __m256i sym62 = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(s62));
+						const __m256i sym63 = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(s63));
+						const __m256i valid = _mm256_or_si256(
+							_mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, sym62)), sym63);
+						if (_mm256_movemask_epi8(valid) != -1) break;
+
+						__m256i offset = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+						offset = _mm256_or_si256(offset, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+						offset = _mm256_or_si256(offset, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+						offset = _mm256_or_si256(offset,
+												 _mm256_and_si256(sym62, _mm256_set1_epi8(static_cast<char>(62 - s62))));
+						offset = _mm256_or_si256(offset,
+												 _mm256_and_si256(sym63, _mm256_set1_epi8(static_cast<char>(63 - s63))));
+						const __m256i sextets = _mm256_add_epi8(c, offset);
+
+						const __m256i pairs = _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140));
+						const __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+						alignas(32) unsigned char block[32];
+						_mm256_store_si256(reinterpret_cast<__m256i*>(block), _mm256_shuffle_epi8(words, pack));
+						std::memcpy(out, block, 12);
+						std::memcpy(out + 12, block + 16, 12);
+					}
+					return i;
+				}
 
-				switch (mod) {
-				case 1:
-					res += alphabet[(triple >> 3 * 6) & 0x3F];
-					res += alphabet[(triple >> 2 * 6) & 0x3F];
-					res += fill;
-					res += fill;
-					break;
-				case 2:
-					res += alphabet[(triple >> 3 * 6) & 0x3F];
-					res += alphabet[(triple >> 2 * 6) & 0x3F];
-					res += alphabet[(triple >> 1 * 6) & 0x3F];
-					res += fill;
-					break;
-				default: break;
+				enum class level { scalar, ssse3, avx2 };
+
+				/// Best instruction set available on this CPU, detected once
+				inline level supported() {
+					static const level best = [] {
+						__builtin_cpu_init();
+						if (__builtin_cpu_supports("avx2")) return level::avx2;
+						if (__builtin_cpu_supports("ssse3")) return level::ssse3;
+						return level::scalar;
+					}();
+					return best;
 				}
 
+				inline std::atomic<level>& selected() {
+					static std::atomic<level> current{supported()};
+					return current;
+				}
+
+				/// Instruction set used by encode/decode; supported() unless lowered with force()
+				inline level detect() { return selected().load(std::memory_order_relaxed); }
+
+				/**
+				 * \brief Selects the instruction set used from now on, so tests can exercise each path
+				 *
+				 * Requests above what the CPU supports are clamped to supported(). Returns the level in effect.
+				 */
+				inline level force(level requested) {
+					const level best = supported();
+					const level effective = requested > best ? best : requested;
+					selected().store(effective, std::memory_order_relaxed);
+					return effective;
+				}
+
+				/// Encodes whole blocks of in[0, len); returns the number of input bytes consumed (a multiple of 3)
+				inline size_t encode(const char* in, size_t len, char* out, char s62, char s63) {
+					size_t done = 0;
+					switch (detect()) {
+					case level::avx2: done = encode_avx2(in, len, out, s62, s63); JWT_FALLTHROUGH;
+					case level::ssse3: done += encode_ssse3(in + done, len - done, out + done / 3 * 4, s62, s63); break;
+					default: break;
+					}
+					return done;
+				}
+
+				/// Decodes whole blocks of in[0, len); returns the number of characters consumed (a multiple of 4)
+				inline size_t decode(const char* in, size_t len, unsigned char* out, char s62, char s63) {
+					size_t done = 0;
+					switch (detect()) {
+					case level::avx2:
+						done = decode_avx2(in, len, out, s62, s63);
+						if (done + 32 <= len) return done; // stopped at an invalid character
+						JWT_FALLTHROUGH;
+					case level::ssse3: done += decode_ssse3(in + done, len - done, out + done / 4 * 3, s62, s63); break;
+					default: break;
+					}
+					return done;
+				}
+			} // namespace simd
+#endif
+
+			inline std::string encode(const std::string& bin, const alphabet::lookup_table& table,
+									  const std::string& fill) {
+				const auto& alphabet = table.symbols;
+				const size_t size = bin.size();
+				const size_t fast_size = size - size % 3;
+				const size_t mod = size % 3;
+
+				// Size the result once and write into it directly
+				std::string res(fast_size / 3 * 4 + (mod == 0 ? 0 : mod + 1 + (3 - mod) * fill.size()), '\0');
+				const auto* in = reinterpret_cast<const unsigned char*>(bin.data());
+				char* out = &res[0];
+
+				size_t i = 0;
+#ifdef JWT_BASE64_SIMD
+				if (table.standard) {
+					i = simd::encode(bin.data(), size, out, alphabet[62], alphabet[63]);
+					out += i / 3 * 4;
+				}
+#endif
+				for (; i < fast_size; i += 3, out += 4) {
+					const uint32_t triple = (uint32_t(in[i]) << 0x10) + (uint32_t(in[i + 1]) << 0x08) + in[i + 2];
+
+					out[0] = alphabet[(triple >> 3 * 6) & 0x3F];
+					out[1] = alphabet[(triple >> 2 * 6) & 0x3F];
+					out[2] = alphabet[(triple >> 1 * 6) & 0x3F];
+					out[3] = alphabet[(triple >> 0 * 6) & 0x3F];
+				}
+
+				if (mod == 0) return res;
+
+				const uint32_t octet_a = in[fast_size];
+				const uint32_t octet_b = mod == 2 ? in[fast_size + 1] : 0;
+				const uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08);
+
+				*out++ = alphabet[(triple >> 3 * 6) & 0x3F];
+				*out++ = alphabet[(triple >> 2 * 6) & 0x3F];
+				if (mod == 2) *out++ = alphabet[(triple >> 1 * 6) & 0x3F];
+				for (size_t n = 0; n < 3 - mod; n++, out += fill.size())
+					std::memcpy(out, fill.data(), fill.size());
+
 				return res;
 			}
 
-			inline std::string decode(const std::string& base, const std::array<char, 64>& alphabet,
-									  const std::vector<std::string>& fill) {
-				const auto pad = count_padding(base, fill);
+			inline std::string encode(const std::string& bin, const std::array<char, 64>& alphabet,
+									  const std::string& fill) {
+				return encode(bin, alphabet::lookup_table(alphabet), fill);
+			}
+
+			inline std::string decode(const std::string& base, const alphabet::lookup_table& table,
+									  const std::string* fills, size_t fill_count) {
+				const auto pad = count_padding(base, fills, fill_count);
 				if (pad.count > 2) throw std::runtime_error("Invalid input: too much fill");
 
 				const size_t size = base.size() - pad.length;
 				if ((size + pad.count) % 4 != 0) throw std::runtime_error("Invalid input: incorrect total size");
 
-				size_t out_size = size / 4 * 3;
-				std::string res;
-				res.reserve(out_size);
-
-				auto get_sextet = [&](size_t offset) { return alphabet::index(alphabet, base[offset]); };
+				const size_t fast_size = size - size % 4;
+				std::string res(fast_size / 4 * 3 + (pad.count == 0 ? 0 : 3 - pad.count), '\0');
+				auto* out = reinterpret_cast<unsigned char*>(&res[0]);
 
-				size_t fast_size = size - size % 4;
-				for (size_t i = 0; i < fast_size;) {
-					uint32_t sextet_a = get_sextet(i++);
-					uint32_t sextet_b = get_sextet(i++);
-					uint32_t sextet_c = get_sextet(i++);
-					uint32_t sextet_d = get_sextet(i++);
+				auto get_sextet = [&](size_t offset) { return table.index(base[offset]); };
 
-					uint32_t triple =
-						(sextet_a << 3 * 6) + (sextet_b << 2 * 6) + (sextet_c << 1 * 6) + (sextet_d << 0 * 6);
+				size_t i = 0;
+#ifdef JWT_BASE64_SIMD
+				if (table.standard) {
+					i = simd::decode(base.data(), fast_size, out, table.symbols[62], table.symbols[63]);
+					out += i / 4 * 3;
+				}
+#endif
+				for (; i < fast_size; i += 4, out += 3) {
+					const uint32_t triple = (get_sextet(i) << 3 * 6) + (get_sextet(i + 1) << 2 * 6) +
+											(get_sextet(i + 2) << 1 * 6) + (get_sextet(i + 3) << 0 * 6);
 
-					res += static_cast<char>((triple >> 2 * 8) & 0xFFU);
-					res += static_cast<char>((triple >> 1 * 8) & 0xFFU);
-					res += static_cast<char>((triple >> 0 * 8) & 0xFFU);
+					out[0] = static_cast<unsigned char>((triple >> 2 * 8) & 0xFFU);
+					out[1] = static_cast<unsigned char>((triple >> 1 * 8) & 0xFFU);
+					out[2] = static_cast<unsigned char>((triple >> 0 * 8) & 0xFFU);
 				}
 
 				if (pad.count == 0) return res;
@@ -214,31 +478,52 @@ namespace jwt {
 				switch (pad.count) {
 				case 1:
 					triple |= (get_sextet(fast_size + 2) << 1 * 6);
-					res += static_cast<char>((triple >> 2 * 8) & 0xFFU);
-					res += static_cast<char>((triple >> 1 * 8) & 0xFFU);
+					out[0] = static_cast<unsigned char>((triple >> 2 * 8) & 0xFFU);
+					out[1] = static_cast<unsigned char>((triple >> 1 * 8) & 0xFFU);
 					break;
-				case 2: res += static_cast<char>((triple >> 2 * 8) & 0xFFU); break;
+				case 2: out[0] = static_cast<unsigned char>((triple >> 2 * 8) & 0xFFU); break;
 				default: break;
 				}
 
 				return res;
 			}
 
+			inline std::string decode(const std::string& base, const alphabet::lookup_table& table,
+									  const std::vector<std::string>& fill) {
+				return decode(base, table, fill.data(), fill.size());
+			}
+
+			inline std::string decode(const std::string& base, const alphabet::lookup_table& table,
+									  const std::string& fill) {
+				return decode(base, table, &fill, 1);
+			}
+
+			inline std::string decode(const std::string& base, const std::array<char, 64>& alphabet,
+									  const std::vector<std::string>& fill) {
+				return decode(base, alphabet::lookup_table(alphabet), fill);
+			}
+
 			inline std::string decode(const std::string& base, const std::array<char, 64>& alphabet,
 									  const std::string& fill) {
-				return decode(base, alphabet, std::vector<std::string>{fill});
+				return decode(base, alphabet::lookup_table(alphabet), fill);
+			}
+
+			/// Lookup table for an alphabet type, built on first use
+			template<typename T>
+			const alphabet::lookup_table& table() {
+				static const alphabet::lookup_table instance(T::data());
+				return instance;
 			}
 
 			inline std::string pad(const std::string& base, const std::string& fill) {
-				std::string padding;
-				switch (base.size() % 4) {
-				case 1: padding += fill; JWT_FALLTHROUGH;
-				case 2: padding += fill; JWT_FALLTHROUGH;
-				case 3: padding += fill; JWT_FALLTHROUGH;
-				default: break;
-				}
+				const size_t count = base.size() % 4 == 0 ? 0 : 4 - base.size() % 4;
+				std::string res;
+				res.reserve(base.size() + count * fill.size());
+				res.append(base);
+				for (size_t i = 0; i < count; i++)
+					res.append(fill);
 
-				return base + padding;
+				return res;
 			}
 
 			inline std::string trim(const std::string& base, const std::string& fill) {
@@ -259,7 +544,7 @@ namespace jwt {
 		 */
 		template<typename T>
 		std::string encode(const std::string& bin) {
-			return details::encode(bin, T::data(), T::fill());
+			return details::encode(bin, details::table<T>(), T::fill());
 		}
 		/**
 		 * \brief Generic base64 decoding
@@ -273,7 +558,7 @@ namespace jwt {
 		 */
 		template<typename T>
 		std::string decode(const std::string& base) {
-			return details::decode(base, T::data(), T::fill());
+			return details::decode(base, details::table<T>(), T::fill());
 		}
 		/**
 		 * \brief Generic base64 padding
@@ -0,0 +1,34 @@
+// tests/TestUtil.h
+// 测试用的最小断言：失败时打印位置并让进程以非 0 退出，make test 据此停止
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <cstdio>
+#include <cstdlib>
+
+inline int &testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            testFailures()++;                                                    \
+        }                                                                        \
+    } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
+
+// 在 main 结尾调用
+inline int testResult(const char *name) {
+    if (testFailures() != 0) {
+        std::fprintf(stderr, "%s: %d check(s) failed\n", name, testFailures());
+        return EXIT_FAILURE;
+    }
+    std::printf("%s: ok\n", name);
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,183 @@
+// tests/base64_test.cpp
+// jwt-cpp base.h 的编解码：标量、SSSE3、AVX2 三条路径（用 simd::force 逐个选择）都要和逐位实现的参考编码一致，
+// 覆盖各种填充写法和非法输入；另外单独检查每个 SIMD 核心。CPU 不支持的路径会打印出来并跳过。
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <jwt-cpp/base.h>
+#include "TestUtil.h"
+
+static const char *kBase64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char *kBase64Url = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// 参考编码：逐位取 6 位，不足 4 个字符时补 fill
+static std::string referenceEncode(const std::string &bin, const char *alphabet, const std::string &fill) {
+    std::string out;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (unsigned char c : bin) {
+        acc = (acc << 8) | c;
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            out += alphabet[(acc >> bits) & 0x3F];
+        }
+    }
+    if (bits > 0) {
+        out += alphabet[(acc << (6 - bits)) & 0x3F];
+    }
+    for (size_t missing = (4 - out.size() % 4) % 4; missing > 0; missing--) {
+        out += fill;
+    }
+    return out;
+}
+
+static std::string randomBytes(std::mt19937 &rng, size_t n) {
+    std::string bin(n, '\0');
+    for (char &c : bin) {
+        c = static_cast<char>(rng());
+    }
+    return bin;
+}
+
+template<typename F>
+static bool throwsRuntimeError(F f) {
+    try {
+        f();
+    } catch (const std::runtime_error &) {
+        return true;
+    }
+    return false;
+}
+
+// 当前选中的路径下做随机往返（长度覆盖 AVX2 的 24/32 字节块和 SSSE3 的 12/16 字节块的各种余数）
+static void testRoundTrip(std::mt19937 &rng) {
+    using namespace jwt::base;
+    for (size_t n = 0; n < 300; n++) {
+        std::string bin = randomBytes(rng, n);
+
+        std::string b64 = encode<jwt::alphabet::base64>(bin);
+        CHECK_EQ(b64, referenceEncode(bin, kBase64, "="));
+        CHECK_EQ(decode<jwt::alphabet::base64>(b64), bin);
+
+        std::string url = encode<jwt::alphabet::base64url>(bin);
+        CHECK_EQ(url, referenceEncode(bin, kBase64Url, "%3d"));
+        CHECK_EQ(decode<jwt::alphabet::base64url>(url), bin);
+
+        // JWT 里用的是去掉填充的写法
+        std::string trimmed = trim<jwt::alphabet::base64url>(url);
+        CHECK_EQ(pad<jwt::alphabet::base64url>(trimmed), url);
+        CHECK_EQ(decode<jwt::alphabet::base64url>(pad<jwt::alphabet::base64url>(trimmed)), bin);
+    }
+}
+
+static void testPadding() {
+    using namespace jwt::base;
+    using percent = jwt::alphabet::helper::base64url_percent_encoding;
+    CHECK_EQ(encode<jwt::alphabet::base64>("a"), "YQ==");
+    CHECK_EQ(encode<jwt::alphabet::base64>("ab"), "YWI=");
+    CHECK_EQ(encode<jwt::alphabet::base64>("abc"), "YWJj");
+    CHECK_EQ(encode<jwt::alphabet::base64url>("a"), "YQ%3d%3d");
+    CHECK_EQ(decode<jwt::alphabet::base64>("YQ=="), "a");
+    CHECK_EQ(decode<jwt::alphabet::base64>("YWI="), "ab");
+    CHECK_EQ(decode<jwt::alphabet::base64url>("YQ%3d%3d"), "a");
+    // 百分号编码的两种大小写都接受，也可以混用
+    CHECK_EQ(decode<percent>("YQ%3D%3D"), "a");
+    CHECK_EQ(decode<percent>("YQ%3d%3D"), "a");
+    CHECK_EQ(decode<percent>("YWI%3D"), "ab");
+    CHECK_EQ(trim<jwt::alphabet::base64>("YQ=="), "YQ");
+    CHECK_EQ(pad<jwt::alphabet::base64>("YQ"), "YQ==");
+    CHECK_EQ(pad<jwt::alphabet::base64>("YWJj"), "YWJj");
+}
+
+static void testInvalid(std::mt19937 &rng) {
+    using namespace jwt::base;
+    CHECK(throwsRuntimeError([] { decode<jwt::alphabet::base64>("YQ="); }));       // 总长度不对
+    CHECK(throwsRuntimeError([] { decode<jwt::alphabet::base64>("Y==="); }));      // 填充太多
+    CHECK(throwsRuntimeError([] { decode<jwt::alphabet::base64>("YWJ"); }));       // 缺填充
+    CHECK(throwsRuntimeError([] { decode<jwt::alphabet::base64>("YW-j"); }));      // base64url 的字符
+    CHECK(throwsRuntimeError([] { decode<jwt::alphabet::base64url>("YW+j"); }));   // base64 的字符
+    CHECK(throwsRuntimeError([] { decode<jwt::alphabet::base64>("YQ%3d%3d"); }));  // 另一种填充
+
+    // 非法字符出现在任意位置（SIMD 块内部、块之间、标量收尾部分）都要抛出
+    const char invalid[] = {'=', '.', '*', ' ', '\0', '\x80', '\xff', '-'};
+    for (size_t n = 3; n < 200; n += 3) {
+        std::string enc = encode<jwt::alphabet::base64>(randomBytes(rng, n));
+        for (size_t pos = 0; pos < enc.size(); pos += 1 + rng() % 5) {
+            std::string bad = enc;
+            bad[pos] = invalid[rng() % sizeof(invalid)];
+            if (bad[pos] == '=' && pos + 2 >= bad.size()) {
+                continue;   // 末尾两个字符换成 = 是合法的填充
+            }
+            CHECK(throwsRuntimeError([&] { decode<jwt::alphabet::base64>(bad); }));
+        }
+    }
+}
+
+#ifdef JWT_BASE64_SIMD
+// 直接调用各个核心：只处理整块，已处理的部分必须和参考结果一致，遇到非法字符的块不能处理
+static void testKernels(std::mt19937 &rng) {
+    using namespace jwt::base::details;
+    using simd::level;
+    const jwt::alphabet::lookup_table &sextets = table<jwt::alphabet::base64url>();
+    for (level lv : {level::ssse3, level::avx2}) {
+        if (simd::supported() < lv) {
+            continue;
+        }
+        for (int iter = 0; iter < 2000; iter++) {
+            size_t n = rng() % 400;
+            std::string bin = randomBytes(rng, n);
+            std::string ref = referenceEncode(bin, kBase64Url, "");
+
+            std::string out(n / 3 * 4 + 64, '\0');
+            size_t done = lv == level::ssse3 ? simd::encode_ssse3(bin.data(), n, &out[0], '-', '_')
+                                             : simd::encode_avx2(bin.data(), n, &out[0], '-', '_');
+            CHECK(done % 3 == 0 && done <= n);
+            CHECK(out.compare(0, done / 3 * 4, ref, 0, done / 3 * 4) == 0);
+
+            std::string chars = ref.substr(0, ref.size() - ref.size() % 4);
+            size_t corrupt = std::string::npos;
+            if (rng() % 3 == 0 && !chars.empty()) {
+                corrupt = rng() % chars.size();
+                chars[corrupt] = '=';
+            }
+            std::string dec(chars.size() / 4 * 3 + 64, '\0');
+            size_t used = lv == level::ssse3
+                ? simd::decode_ssse3(chars.data(), chars.size(), reinterpret_cast<unsigned char *>(&dec[0]), '-', '_')
+                : simd::decode_avx2(chars.data(), chars.size(), reinterpret_cast<unsigned char *>(&dec[0]), '-', '_');
+            CHECK(used % 4 == 0 && used <= chars.size());
+            CHECK(corrupt == std::string::npos || used <= corrupt);
+            for (size_t j = 0; j < used; j++) {
+                CHECK(sextets.sextets[static_cast<unsigned char>(chars[j])] >= 0);
+            }
+            CHECK(dec.compare(0, used / 4 * 3, bin, 0, used / 4 * 3) == 0);
+        }
+    }
+}
+#endif
+
+int main() {
+    std::mt19937 rng(7);
+#ifdef JWT_BASE64_SIMD
+    using jwt::base::details::simd::level;
+    const char *names[] = {"scalar", "ssse3", "avx2"};
+    for (level lv : {level::scalar, level::ssse3, level::avx2}) {
+        level effective = jwt::base::details::simd::force(lv);
+        if (effective != lv) {
+            std::printf("base64_test: %s not supported by this CPU, skipped\n", names[static_cast<int>(lv)]);
+            continue;
+        }
+        CHECK(jwt::base::details::simd::detect() == lv);
+        testRoundTrip(rng);
+        testPadding();
+        testInvalid(rng);
+    }
+    jwt::base::details::simd::force(jwt::base::details::simd::supported());
+    testKernels(rng);
+#else
+    testRoundTrip(rng);
+    testPadding();
+    testInvalid(rng);
+#endif
+    return testResult("base64_test");
+}
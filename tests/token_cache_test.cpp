@@ -0,0 +1,127 @@
+// tests/token_cache_test.cpp
+// TokenCache 和 JwtManager 的缓存/注销：同一签名的不同 base64url 写法不能绕过缓存比对和注销
+#include <string>
+#include "JwtManager.h"
+#include "TokenCache.h"
+#include "TestUtil.h"
+
+static const char *kAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// 把签名最后一个字符的最低位翻转：32 字节签名编码成 43 个字符，最后一个字符的低 2 位不参与解码，
+// 宽松的解码器会把结果当成同一个签名（例如 w -> x）
+static std::string flipUnusedBit(const std::string &token) {
+    std::string out = token;
+    char &last = out.back();
+    int v = static_cast<int>(std::string(kAlphabet).find(last));
+    last = kAlphabet[v ^ 1];
+    return out;
+}
+
+// 把签名第一个字符换掉：写法规范，但签名是错的
+static std::string corruptSignature(const std::string &token) {
+    std::string out = token;
+    char &first = out[out.rfind('.') + 1];
+    first = first == 'A' ? 'B' : 'A';
+    return out;
+}
+
+static TokenCache::Digest keyOf(unsigned char tag) {
+    TokenCache::Digest d;
+    d.fill(0);
+    d[0] = tag;
+    return d;
+}
+
+static TokenCache::Signature signatureOf(unsigned char tag) {
+    TokenCache::Signature s;
+    s.fill(tag);
+    return s;
+}
+
+static void testNonCanonicalSignature() {
+    JwtManager &jwt = JwtManager::getInstance();
+    std::string token = jwt.generateToken(7, "alice");
+    std::string variant = flipUnusedBit(token);
+    CHECK(variant != token);
+
+    // 缓存里还没有原 token 时，变体走完整校验也要被拒绝
+    TokenCache::getInstance().setCapacity(0);
+    CHECK(!jwt.verifyToken(variant));
+    CHECK(jwt.verifyToken(token));
+    TokenCache::getInstance().setCapacity(100000);
+
+    // 原 token 进入缓存后，变体既不能命中也不能通过完整校验
+    TokenClaims claims;
+    CHECK(jwt.verifyToken(token, claims));
+    CHECK_EQ(claims.userId, 7);
+    CHECK(!jwt.verifyToken(variant));
+    CHECK_EQ(jwt.getUserIdFromToken(variant), -1);
+
+    // 写法规范但签名错误：摘要相同会找到缓存项，签名比对不一致，按未命中处理后被完整校验拒绝
+    CHECK(!jwt.verifyToken(corruptSignature(token)));
+    CHECK(jwt.verifyToken(token));
+
+    // 注销原 token 后两种写法都被拒绝；用变体注销什么也不做
+    jwt.revokeToken(variant, claims);
+    CHECK(jwt.verifyToken(token));
+    jwt.revokeToken(token, claims);
+    CHECK(!jwt.verifyToken(token));
+    CHECK(!jwt.verifyToken(variant));
+
+    std::string other = jwt.generateToken(8, "bob");
+    CHECK(jwt.verifyToken(other));
+    CHECK_EQ(jwt.getUserIdFromToken(other), 8);
+}
+
+static void testLookup() {
+    TokenCache &cache = TokenCache::getInstance();
+    const int64_t now = 1000;
+    TokenClaims claims;
+    claims.userId = 42;
+    claims.username = "carol";
+    claims.expiresAt = now + 60;
+
+    TokenCache::Digest key = keyOf(1);
+    TokenClaims out;
+    CHECK(cache.lookup(key, signatureOf(1), now, out) == TokenCache::Result::Miss);
+    cache.insert(key, signatureOf(1), claims, now);
+    CHECK(cache.lookup(key, signatureOf(1), now, out) == TokenCache::Result::Hit);
+    CHECK_EQ(out.userId, 42);
+    CHECK(cache.lookup(key, signatureOf(2), now, out) == TokenCache::Result::Miss);
+    // 过期后不再命中
+    CHECK(cache.lookup(key, signatureOf(1), now + 61, out) == TokenCache::Result::Miss);
+
+    // 注销按摘要生效，与签名无关；过期后注销记录失效
+    cache.revoke(key, claims.expiresAt, now);
+    CHECK(cache.lookup(key, signatureOf(1), now, out) == TokenCache::Result::Revoked);
+    CHECK(cache.lookup(key, signatureOf(2), now, out) == TokenCache::Result::Revoked);
+    cache.insert(key, signatureOf(1), claims, now);
+    CHECK(cache.lookup(key, signatureOf(1), now, out) == TokenCache::Result::Revoked);
+    CHECK(cache.lookup(key, signatureOf(1), now + 61, out) == TokenCache::Result::Miss);
+}
+
+static void testEviction() {
+    TokenCache &cache = TokenCache::getInstance();
+    const int64_t now = 1000;
+    TokenClaims claims;
+    claims.userId = 1;
+    claims.expiresAt = now + 60;
+
+    // 每段 1 条；最后一个字节相同的摘要落在同一段，后插入的挤掉先插入的
+    cache.setCapacity(16);
+    uint64_t evictions = cache.stats().evictions;
+    cache.insert(keyOf(10), signatureOf(10), claims, now);
+    cache.insert(keyOf(11), signatureOf(11), claims, now);
+    TokenClaims out;
+    CHECK(cache.lookup(keyOf(10), signatureOf(10), now, out) == TokenCache::Result::Miss);
+    CHECK(cache.lookup(keyOf(11), signatureOf(11), now, out) == TokenCache::Result::Hit);
+    CHECK(cache.stats().evictions >= evictions + 1);
+    cache.setCapacity(100000);
+}
+
+int main() {
+    testNonCanonicalSignature();
+    testLookup();
+    testEviction();
+    return testResult("token_cache_test");
+}
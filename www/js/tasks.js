@@ -1,5 +1,7 @@
 // 任务管理功能
 let currentTasks = [];
+// 服务端任务列表的版本号，增删改的响应带回新版本号
+let taskVersion = null;
 
 // 加载用户任务
 async function loadUserTasks() {
@@ -7,6 +9,7 @@ async function loadUserTasks() {
         const response = await apiCall('/api/profile');
 
         if (response.status === 'success') {
+            taskVersion = response.version;
             displayTasks(response.tasks || []);
             updateTaskStats(response.tasks || []);
         }
@@ -16,6 +19,32 @@ async function loadUserTasks() {
     }
 }
 
+// 用增删改的响应修补本地列表。版本号正好是下一个时直接修补，
+// 否则说明中间漏了其它地方的修改，重新加载整个列表
+async function applyTaskChange(response, patch) {
+    if (taskVersion === null || response.version !== taskVersion + 1) {
+        if (response.version !== taskVersion) {
+            await loadUserTasks();
+        }
+        return;
+    }
+    taskVersion = response.version;
+    const tasks = patch(currentTasks.slice());
+    displayTasks(tasks);
+    updateTaskStats(tasks);
+}
+
+// 按任务ID替换或插入（新任务放在最前面，和服务端的排序一致）
+function upsertTask(tasks, task) {
+    const index = tasks.findIndex(t => t.id === task.id);
+    if (index >= 0) {
+        tasks[index] = task;
+    } else {
+        tasks.unshift(task);
+    }
+    return tasks;
+}
+
 // 显示任务列表
 function displayTasks(tasks) {
     currentTasks = tasks;
@@ -38,8 +67,8 @@ function displayTasks(tasks) {
             </div>
 
             <div class="task-meta">
-                <span>创建: ${formatDate(task.timestamp)}</span>
-                ${task.datetime ? `<span>截止: ${formatDate(task.datetime)}</span>` : ''}
+                <span>创建: ${formatDate(task.created_at)}</span>
+                ${task.due_date ? `<span>截止: ${formatDate(task.due_date)}</span>` : ''}
             </div>
 
             ${task.text ? `<div class="task-text">${escapeHtml(task.text)}</div>` : ''}
@@ -84,7 +113,7 @@ async function addNewTask(taskData) {
         if (response.status === 'success') {
             showMessage('任务添加成功', 'success');
             closeModal();
-            await loadUserTasks();
+            await applyTaskChange(response, tasks => upsertTask(tasks, response.task));
         }
     } catch (error) {
         console.error('添加任务失败:', error);
@@ -102,7 +131,7 @@ async function toggleTask(taskId, completed) {
 
         if (response.status === 'success') {
             showMessage('任务状态已更新', 'success');
-            await loadUserTasks();
+            await applyTaskChange(response, tasks => upsertTask(tasks, response.task));
         }
     } catch (error) {
         console.error('更新任务失败:', error);
@@ -121,7 +150,7 @@ async function deleteTask(taskId) {
 
         if (response.status === 'success') {
             showMessage('任务已删除', 'success');
-            await loadUserTasks();
+            await applyTaskChange(response, tasks => tasks.filter(t => t.id !== response.deleted));
         }
     } catch (error) {
         console.error('删除任务失败:', error);